@@ -23,7 +23,7 @@ class ActorExtension : public ActorTreeNode, public ActorList::Node
 	{
 		using ConverterBase::ConverterBase;
 
-		auto& operator()(Vector3& p) const { return p.RotateAround(pivot, basis1.Transpose()); }
+		auto& operator()(Vector3& p) const { return FusedRotateAround(p, pivot, basis1.Transpose()); }
 		auto& operator()(short& a)   const { return ConvertAngle(a, basis0, basis1); }
 	};
 
@@ -31,7 +31,7 @@ class ActorExtension : public ActorTreeNode, public ActorList::Node
 	{
 		using ConverterBase::ConverterBase;
 
-		auto& operator()(Vector3& p) const { return p.RotateAround(pivot, basis1); }
+		auto& operator()(Vector3& p) const { return FusedRotateAround(p, pivot, basis1); }
 		auto& operator()(short& a)   const { return ConvertAngle(a, basis1, basis0); }
 	};
 
@@ -101,6 +101,7 @@ class ActorExtension : public ActorTreeNode, public ActorList::Node
 
 	Matrix3x3 currMatrix;
 	Vector3 lastUpdatePoint;
+	Vector3 extrapolationPoint; // where currMatrix was last updated or extrapolated for
 
 	Properties <
 		Property<&Actor::pos>,
@@ -109,10 +110,23 @@ class ActorExtension : public ActorTreeNode, public ActorList::Node
 		Property<&Actor::motionAng, &Vector3_16::y>
 	> properties;
 
-	Sqaerp fieldSqaerp;
+	Quaternion transitionStart = 1; // the frame of the actor when it entered its field
 	uint16_t angleToNewField = 0;
+	uint8_t transitionFrame = 0; // the number of updates since the actor entered its field
+	uint16_t matrixVersion = 0; // changes whenever currMatrix does
+	uint8_t numBasisRotations = 0; // since the basis was last built from scratch
 
-	int CalculateUpVector(Vector3_Q24& __restrict__ res, const Vector3& pos, Sqaerp& sqaerp) const;
+	static constexpr uint8_t maxBasisRotations = 16;
+	static constexpr int maxBasisDrift = 8; // in raw Q12 units
+
+	// Beyond each of these distances from the player, the gravity of an actor
+	// is updated half as often as in the previous band (every 1, 2 or 4 frames)
+	static constexpr Fix12i lodBandDists[] = {2000._f, 4000._f};
+
+	int CalculateTransitionFrame(Quaternion& res, const Vector3& pos, unsigned frame) const;
+	bool RotateBasis(const Vector3& prevUp);
+	void ExtrapolateBasis(const Vector3& pos);
+	unsigned GetLodBand() const;
 
 public:
 
@@ -133,6 +147,11 @@ public:
 	const Vector3& GetUpVectorQ12() const { return currMatrix.c1; }
 	const Vector3& GetLastUpdatePoint() const { return lastUpdatePoint; }
 	const Matrix3x3& GetGravityMatrix() const { return currMatrix; }
+	uint16_t GetGravityMatrixVersion() const { return matrixVersion; }
+
+	bool IsInFieldTransition() const { return angleToNewField != 0; }
+
+	static constexpr unsigned numLodBands = std::size(lodBandDists) + 1;
 
 	bool IsInTrivialField() const
 	{
@@ -163,11 +182,8 @@ public:
 		properties.SetAll(GetActor(), Restorer(*this, pivotActor, behavingExtension));
 	}
 
-	int PredictNextUpVector(Vector3_Q24& __restrict__ res, const Vector3& nextPos) const
-	{
-		Sqaerp sqaerpCopy = fieldSqaerp;
-		return CalculateUpVector(res, nextPos, sqaerpCopy);
-	}
+	// The up vector on the next update of a field transition if the actor moves to nextPos
+	int PredictNextUpVector(Vector3_Q24& __restrict__ res, const Vector3& nextPos) const;
 
 	[[gnu::always_inline]]
 	ActorExtension(Actor& actor):
@@ -181,7 +197,7 @@ public:
 		else
 			properties.SetAll(actor);
 
-		lastUpdatePoint = savedPos = GetRealValue<&Actor::pos>();
+		lastUpdatePoint = extrapolationPoint = savedPos = GetRealValue<&Actor::pos>();
 	}
 };
 
@@ -5,6 +5,33 @@
 #include "gravity_field.h"
 #include "gravity_math.h"
 
+// Quantities derived from the view matrices, computed once per frame right after they are set
+struct ViewContext
+{
+	// The axes of the camera in Q24 (the columns of INV_VIEW_MATRIX_ASR_3)
+	Vector3_Q24 camXAxis = {1._f24, 0._f24, 0._f24};
+	Vector3_Q24 camYAxis = {0._f24, 1._f24, 0._f24};
+	Vector3_Q24 camZAxis = {0._f24, 0._f24, 1._f24};
+
+	Matrix4x3 skyBoxMatrix {}; // the rotation of VIEW_MATRIX_ASR_3 without its translation
+
+	void Update();
+
+	// SphericalForwardField for the camera axes
+	void CalculateForwardField(Vector3& __restrict__ res, const Vector3_Q24& up);
+
+private:
+	// The player's basis and input angle need the forward field for nearly the same up vector
+	// on every frame, so the last result is reused while the up vector stays this close
+	static constexpr int maxForwardFieldUpDiff = 4 << 12; // in raw Q24 units
+
+	Vector3_Q24 forwardFieldUp {};
+	Vector3 forwardField {};
+	bool forwardFieldValid = false;
+};
+
+extern constinit ViewContext viewContext;
+
 class CamCtrl
 {
 public:
@@ -0,0 +1,51 @@
+#pragma once
+#include "gravity_math.h"
+
+// A solid capsule or a cylinder with flat caps that answers collision queries
+// in closed form instead of testing each collision triangle of a mesh
+class CapsuleClsn
+{
+	CapsuleClsn* next = nullptr;
+	Vector3 p0;
+	Vector3 axis;
+	Fix12i length;
+	Fix12i radius;
+	Fix24i invRadius;
+	CLPS clps;
+	bool flatCaps;
+
+	CapsuleClsn(const CapsuleClsn&) = delete;
+	CapsuleClsn(CapsuleClsn&&) = delete;
+	CapsuleClsn& operator=(const CapsuleClsn&) = delete;
+	CapsuleClsn& operator=(CapsuleClsn&&) = delete;
+
+	bool CanIntersect(const Vector3& pos, Fix12i dist) const;
+	Fix24i FindEntry(const Vector3& pos0, const Vector3& dir) const;
+
+	friend struct FieldGenerator;
+
+public:
+	CapsuleClsn(const Vector3& p0, const Vector3& p1, Fix12i radius, bool flatCaps, const CLPS& clps);
+
+	// The collision parameters of the whole surface
+	const CLPS& GetCLPS() const { return clps; }
+
+	// Returns the signed distance from pos to the surface (negative when pos is inside)
+	// and sets normal to the outward normal of the surface point closest to pos
+	Fix12i CalculateSignedDist(Vector3& normal, const Vector3& pos) const;
+
+	// Returns whether the segment from pos0 to pos1 enters the collider from the outside
+	bool Raycast(Vector3& clsnPos, Vector3& normal, const Vector3& pos0, const Vector3& pos1) const;
+
+	// Returns whether the sphere overlaps the collider, sets res to the vector
+	// that pushes it out and sets normal to the direction of that vector
+	bool CalculatePushback(Vector3& res, Vector3& normal, const Vector3& center, Fix12i sphereRadius) const;
+
+	// The colliders are spawned along with the gravity fields of the level (see FieldGenerator)
+	static const CapsuleClsn* GetFirst();
+
+	// Like the functions above, but for all colliders in the level. They return the collider
+	// that was hit (the one that pushed the sphere the most) or nullptr if there was none.
+	static const CapsuleClsn* RaycastAll(Vector3& clsnPos, Vector3& normal, const Vector3& pos0, const Vector3& pos1);
+	static const CapsuleClsn* CalculatePushbackAll(Vector3& res, Vector3& normal, const Vector3& center, Fix12i sphereRadius);
+};
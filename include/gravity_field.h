@@ -12,6 +12,7 @@ class GravityField
 	u8 camSettingsID;
 	bool homogeneous : 1;
 	bool trivial : 1;
+	bool particleGravity : 1;
 
 	GravityField(const GravityField&) = delete;
 	GravityField(GravityField&&) = delete;
@@ -28,14 +29,16 @@ protected:
 		priority(-1),
 		camSettingsID(0xff),
 		homogeneous(true),
-		trivial(true)
+		trivial(true),
+		particleGravity(false)
 	{}
 
 	GravityField(PathPtr pathPtr, bool homogeneous, bool trivial = false):
 		priority(pathPtr->param2),
 		camSettingsID(pathPtr->param3),
 		homogeneous(homogeneous),
-		trivial(trivial)
+		trivial(trivial),
+		particleGravity((pathPtr->param1 - pathBaseParam1) & particleGravityFlag)
 	{}
 
 public:
@@ -45,12 +48,15 @@ public:
 	virtual Fix12i GetAltitude(const Vector3& pos) const = 0;
 	virtual Fix12i GetAltitudeAndUpVectorQ24(Vector3_Q24& res, const Vector3& pos) const = 0;
 	virtual const Vector3* GetHomogeneousUpVectorQ12() const = 0;
+	virtual void CalculateUpVectorDerivativeQ24(Vector3& res, const Vector3& pos, const Vector3& dir) const = 0;
+	virtual Fix12i GetNormalAcceleration(const Vector3& pos, const Vector3& vel) const = 0;
 	virtual bool Contains(const Vector3& pos) const = 0;
 	virtual bool Contains(const Vector3& pos, Fix12i altitude) const = 0;
 
 	void InitBasis(Vector3_Q24& xAxis, Vector3_Q24& yAxis, const Vector3& pos) const;
 
 	static constexpr u8 pathBaseParam1 = 0x40;
+	static constexpr u8 particleGravityFlag = 0x08; // added to the field ID in path parameter 1
 
 	static GravityField& GetFieldAt(const Vector3& pos);
 	static GravityField& GetFieldFor(const Actor& actor, const ActorList::Node& node);
@@ -64,6 +70,7 @@ public:
 	u32  GetCamSettingsID() const { return camSettingsID; }
 	bool IsHomogeneous()    const { return homogeneous; }
 	bool IsTrivial()        const { return trivial; }
+	bool HasParticleGravity() const { return particleGravity; }
 
 	[[gnu::always_inline]]
 	auto GetUpVectorQ12(const Vector3& pos) const
@@ -83,6 +90,17 @@ public:
 		});
 	}
 
+	// The Jacobian of the up vector at pos times dir, so the up vector
+	// at pos + dir is about GetUpVectorQ24(pos) + GetUpVectorDerivativeQ24(pos, dir)
+	[[gnu::always_inline]]
+	auto GetUpVectorDerivativeQ24(const Vector3& pos, const Vector3& dir) const
+	{
+		return Vector3_Q24::Proxy([this, &pos, &dir]<bool resMayAlias> [[gnu::always_inline]] (Vector3& res)
+		{
+			CalculateUpVectorDerivativeQ24(res, pos, dir);
+		});
+	}
+
 	[[gnu::always_inline]]
 	auto GetAltitudeVector(const Vector3& pos) const
 	{
@@ -27,6 +27,43 @@ public:
 		if (dot >= 0_f) res -= v*dot;
 	}
 
+	// Sets the altitude vector at pos, and removes the component of dir parallel
+	// to the axis if pos is beside it, since the field doesn't curve along the axis
+	void CalculateCurvedPart(Vector3& altitudeVec, Vector3& dir, const Vector3& pos) const
+	{
+		altitudeVec = pos - p1;
+		if (v.Dot(altitudeVec) > 0_f) return;
+
+		altitudeVec = pos - p0;
+		const Fix12i dot = v.Dot(altitudeVec);
+
+		if (dot >= 0_f)
+		{
+			altitudeVec -= v*dot;
+			dir -= v*v.Dot(dir);
+		}
+	}
+
+	Fix12i GetNormalAcceleration(const Vector3& pos, const Vector3& vel) const
+	{
+		Vector3 altitudeVec;
+		Vector3 curvedVel = vel;
+		CalculateCurvedPart(altitudeVec, curvedVel, pos);
+
+		const Fix12i altitude = altitudeVec.Len();
+
+		return altitude > 0_f ? curvedVel.Dot(curvedVel) / altitude : 0_f;
+	}
+
+	void CalculateUpVectorDerivative(Vector3& res, const Vector3& pos, const Vector3& dir) const
+	{
+		Vector3 altitudeVec;
+		Vector3 curvedDir = dir;
+		CalculateCurvedPart(altitudeVec, curvedDir, pos);
+
+		CalculateNormalizedDerivative(res, altitudeVec, curvedDir);
+	}
+
 	bool Contains(const Vector3& pos, Fix12i altitude) const
 	{
 		return altitude <= radius;
@@ -19,6 +19,18 @@ public:
 		res = pos - center;
 	}
 
+	Fix12i GetNormalAcceleration(const Vector3& pos, const Vector3& vel) const
+	{
+		const Fix12i altitude = center.Dist(pos);
+
+		return altitude > 0_f ? vel.Dot(vel) / altitude : 0_f;
+	}
+
+	void CalculateUpVectorDerivative(Vector3& res, const Vector3& pos, const Vector3& dir) const
+	{
+		CalculateNormalizedDerivative(res, pos - center, dir);
+	}
+
 	bool Contains(const Vector3& pos, Fix12i altitude) const
 	{
 		return altitude <= radius;
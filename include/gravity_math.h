@@ -1,13 +1,48 @@
 #pragma once
 #include <ranges>
+#include <tuple>
 #include "SM64DS_PI.h"
 
 struct Vector3_Q24;
 
 extern "C"
 {
-	int DivQ24(int num, int den);
 	uint64_t Div64(uint64_t nom, uint64_t den);
+
+#ifdef __arm__
+	int HardwareDivQ24(int num, int den);
+
+	// Starts the same division as DivQ24 without waiting for it to finish.
+	// Nothing else may use the divider before the result is fetched.
+	void DivQ24Async(int num, int den);
+	int DivQ24Result();
+#endif
+}
+
+// Gives the same result as the hardware divider in HardwareDivQ24
+constexpr int SoftwareDivQ24(int num, int den)
+{
+	const int64_t quotient = (static_cast<int64_t>(num) << 32) / den;
+
+	return static_cast<int>((quotient + 0x80) >> 8);
+}
+
+#ifndef __arm__
+// Without the DS hardware (e.g. when testing the math on a PC), the division is done
+// in software with the same result, and the "asynchronous" result is kept until it is fetched
+
+inline constinit int softwareDivResult = 0;
+
+inline int HardwareDivQ24(int num, int den) { return SoftwareDivQ24(num, den); }
+inline void DivQ24Async(int num, int den) { softwareDivResult = SoftwareDivQ24(num, den); }
+inline int DivQ24Result() { return softwareDivResult; }
+#endif
+
+// Returns (num << 24) / den rounded to the nearest integer
+constexpr int DivQ24(int num, int den)
+{
+	if consteval { return SoftwareDivQ24(num, den); }
+	else         { return HardwareDivQ24(num, den); }
 }
 
 template<FixUR T>
@@ -15,8 +50,8 @@ struct Fix24 : Fix<T, 24, Fix24>
 {
 	using Fix<T, 24, Fix24>::Fix;
 
-	Fix24<int> operator/ (Fix24 fix) const { return {DivQ24(this->val, fix.val), as_raw}; }
-	Fix24&     operator/=(Fix24 fix) &     { this->val = DivQ24(this->val, fix.val); return *this; }
+	constexpr Fix24<int> operator/ (Fix24 fix) const { return {DivQ24(this->val, fix.val), as_raw}; }
+	constexpr Fix24&     operator/=(Fix24 fix) &     { this->val = DivQ24(this->val, fix.val); return *this; }
 
 	template<typename U> constexpr explicit
 	operator Fix12<U>() const { return {(this->val + 0x800) >> 12, as_raw}; }
@@ -46,6 +81,11 @@ struct Vector3_Q24
 	static void CalculateCross(Vector3& res, const Vector3& v0, const Vector3& v1);
 	static void CalculateNormalized(Vector3& res, const Vector3& v);
 
+	// CalculateNormalized split in two, so that other work can be done while the divider is busy.
+	// Nothing else may use the divider in between.
+	static void NormalizeAsync(Vector3& scaled, const Vector3& v);
+	static void NormalizeResult(Vector3& res, const Vector3& scaled);
+
 	template<class F>
 	class Proxy
 	{
@@ -127,17 +167,6 @@ struct Vector3_Q24
 			});
 		}
 
-		[[gnu::always_inline, nodiscard]]
-		auto NormalizedTwice() &&
-		{
-			return NewProxy([this]<bool resMayAlias> [[gnu::always_inline]] (Vector3& res)
-			{
-				Eval<resMayAlias>(res);
-				NormalizeInPlace(res);
-				NormalizeInPlace(res);
-			});
-		}
-
 		[[gnu::always_inline, nodiscard]]
 		auto StoreAsQ12() &&
 		{
@@ -360,21 +389,10 @@ struct Vector3_Q24
 		});
 	}
 
-	[[gnu::always_inline, nodiscard]]
-	auto NormalizedTwice() const
-	{
-		return Proxy([this]<bool resMayAlias> [[gnu::always_inline]] (Vector3& res)
-		{
-			CalculateNormalized(res, this->data);
-			NormalizeInPlace(res);
-		});
-	}
-
 	template<class F>
 	Fix24i Dot(Proxy<F>&& proxy) const { return CalculateDot(this->data, static_cast<Vector3_Q24>(std::move(proxy)).data); }
 	Fix24i Dot(const Vector3_Q24& v) const { return CalculateDot(this->data, v.data); }
 	void Normalize()      & { NormalizeInPlace(data); }
-	void NormalizeTwice() & { NormalizeInPlace(data);  NormalizeInPlace(data); }
 	
 	int AngleTo(const Vector3_Q24& other) const
 	{
@@ -516,8 +534,123 @@ inline const ostream& operator<<(const ostream& os, const Vector3_Q24& vec)
 	return os;
 }
 
-[[gnu::const]] Fix24i Sqrt(Fix24i x);
-[[gnu::const]] Fix24i CosQ24(short a);
+// Gives the same result as the hardware square root unit in HardwareSqrt
+constexpr Fix24i SoftwareSqrt(Fix24i x)
+{
+	uint64_t rem = static_cast<uint64_t>(static_cast<int64_t>(x.val) << 26);
+	uint64_t root = 0;
+
+	for (uint64_t bit = uint64_t(1) << 62; bit != 0; bit >>= 2)
+	{
+		if (rem >= root + bit)
+		{
+			rem -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+	}
+
+	return {static_cast<int>(static_cast<uint32_t>(root) + 1) >> 1, as_raw};
+}
+
+#ifdef __arm__
+[[gnu::const]] Fix24i HardwareSqrt(Fix24i x);
+
+// Like DivQ24Async and DivQ24Result, but for Sqrt
+void SqrtQ24Async(Fix24i x);
+Fix24i SqrtQ24Result();
+#else
+// The software backend of the square root unit, like the one of the divider
+
+inline constinit Fix24i softwareSqrtResult = {0, as_raw};
+
+inline Fix24i HardwareSqrt(Fix24i x) { return SoftwareSqrt(x); }
+inline void SqrtQ24Async(Fix24i x) { softwareSqrtResult = SoftwareSqrt(x); }
+inline Fix24i SqrtQ24Result() { return softwareSqrtResult; }
+#endif
+
+constexpr Fix24i Sqrt(Fix24i x)
+{
+	if consteval { return SoftwareSqrt(x); }
+	else         { return HardwareSqrt(x); }
+}
+
+#ifdef GRAVITY_SINCOS_TABLE
+
+// cos(i * 90° / 64) for i in [0, 64]
+inline constexpr int cosTableQ24[65] =
+{
+	0x1000000, 0x0ffec43, 0x0ffb10f, 0x0ff4e6d, 0x0fec46d, 0x0fe1324, 0x0fd3aac, 0x0fc3b28,
+	0x0fb14be, 0x0f9c79d, 0x0f853f8, 0x0f6ba07, 0x0f4fa0b, 0x0f31447, 0x0f10908, 0x0eed89e,
+	0x0ec835e, 0x0ea09a7, 0x0e76bd8, 0x0e4aa59, 0x0e1c598, 0x0debe05, 0x0db941a, 0x0d84853,
+	0x0d4db31, 0x0d14d3d, 0x0cd9f02, 0x0c9d112, 0x0c5e403, 0x0c1d870, 0x0bdaef9, 0x0b96842,
+	0x0b504f3, 0x0b085bb, 0x0abeb4a, 0x0a73656, 0x0a26799, 0x09d7fd1, 0x0987fc0, 0x093682a,
+	0x08e39da, 0x088f59b, 0x0839c3d, 0x07e2e93, 0x078ad75, 0x07319ba, 0x06d7440, 0x067bde5,
+	0x061f78b, 0x05c2215, 0x0563e6a, 0x0504d72, 0x04a5019, 0x044474a, 0x03e33f3, 0x0381705,
+	0x031f170, 0x02bc429, 0x0259021, 0x01f564e, 0x01917a7, 0x012d521, 0x00c8fb3, 0x0064855,
+	0x0000000,
+};
+
+// Cubic Hermite interpolation between the entries of the table. The derivatives
+// come from the table as well, since the derivative of cos is -sin.
+// The maximum error is 1 raw unit. Assumes that 0 <= b <= 90_deg.
+constexpr Fix24i CosFirstQuadrantQ24(int b)
+{
+	const int i = b >> 8;
+
+	if (i == 64)
+		return 0._f24;
+
+	constexpr Fix24i step = 0x0'06487f_f24; // 90° / 64 in radians
+
+	const int64_t p0 = cosTableQ24[i];
+	const int64_t p1 = cosTableQ24[i + 1];
+	const int64_t m0 = -(Fix24i(cosTableQ24[64 - i], as_raw) * step).val;
+	const int64_t m1 = -(Fix24i(cosTableQ24[63 - i], as_raw) * step).val;
+
+	const int64_t t  = (b & 0xff) << 16;
+	const int64_t t2 = t  * t >> 24;
+	const int64_t t3 = t2 * t >> 24;
+
+	const int64_t h00 = 2 * t3 - 3 * t2 + (1 << 24);
+	const int64_t h10 = t3 - 2 * t2 + t;
+	const int64_t h01 = 3 * t2 - 2 * t3;
+	const int64_t h11 = t3 - t2;
+
+	return {static_cast<int>((h00 * p0 + h10 * m0 + h01 * p1 + h11 * m1 + (1 << 23)) >> 24), as_raw};
+}
+
+#else
+
+// A cubic polynomial with a maximum error of about 0.0005. Assumes that 0 <= b <= 90_deg.
+constexpr Fix24i CosFirstQuadrantQ24(int b)
+{
+	const Fix24i x = {b << 10, as_raw};
+
+	return 1._f24 - (0x1'41ff5e_f24 - (0x0'2be0ed_f24*x + 0x0'161e72_f24)*x)*x*x;
+}
+
+#endif
+
+constexpr Fix24i CosQ24(short a)
+{
+	int b = a;
+	if (b < 0) b = -b;
+
+	bool flipped;
+
+	if (b > 0x4000)
+	{
+		b = 0x8000 - b;
+		flipped = true;
+	}
+	else flipped = false;
+
+	const Fix24i res = CosFirstQuadrantQ24(b);
+
+	return flipped ? -res : res;
+}
 
 inline Fix12i IterateSmoothStep(Fix12i t, unsigned n)
 {
@@ -529,10 +662,9 @@ inline Fix12i IterateSmoothStep(Fix12i t, unsigned n)
 
 void SphericalForwardField(Vector3& __restrict__ res, const Vector3_Q24& xAxis, const Vector3_Q24& yAxis, const Vector3_Q24& up);
 
-inline void SphericalMatrixField(Matrix3x3& __restrict__ res, const Vector3_Q24& xAxis, const Vector3_Q24& yAxis, const Vector3_Q24& up)
+// Builds the rest of the basis after res.c2 has been set by SphericalForwardField
+inline void CompleteSphericalMatrixField(Matrix3x3& __restrict__ res, const Vector3_Q24& up)
 {
-	SphericalForwardField(res.c2, xAxis, yAxis, up);
-
 	Vector3_Q24::CalculateCross(res.c0, up.data, res.c2);
 
 	res.c0.NormalizeTwice();
@@ -540,6 +672,100 @@ inline void SphericalMatrixField(Matrix3x3& __restrict__ res, const Vector3_Q24&
 	res.c2.NormalizeTwice();
 }
 
+inline void SphericalMatrixField(Matrix3x3& __restrict__ res, const Vector3_Q24& xAxis, const Vector3_Q24& yAxis, const Vector3_Q24& up)
+{
+	SphericalForwardField(res.c2, xAxis, yAxis, up);
+	CompleteSphericalMatrixField(res, up);
+}
+
+// Q12 matrix-vector products that accumulate in 64 bits and round only once. res may alias v.
+void FusedMul(Vector3& res, const Matrix3x3& m, const Vector3& v);
+void FusedMul(Vector3& res, const Matrix3x3::TransposeProxy& m, const Vector3& v);
+
+// Like Matrix3x3::operator(), but with the fused products. res may alias m1, but not m0.
+template<class M>
+inline void FusedMul(Matrix3x3& res, const M& m0, const Matrix3x3& m1)
+{
+	FusedMul(res.c0, m0, m1.c0);
+	FusedMul(res.c1, m0, m1.c1);
+	FusedMul(res.c2, m0, m1.c2);
+}
+
+// Like Vector3::RotateAround, but with the fused products
+template<class M>
+inline Vector3& FusedRotateAround(Vector3& v, const Vector3& pivot, const M& m)
+{
+	v -= pivot;
+	FusedMul(v, m, v);
+	v += pivot;
+
+	return v;
+}
+
+// A product of matrices (Matrix3x3 or Matrix3x3::TransposeProxy) that is only evaluated when applied.
+// Vectors are multiplied from right to left, which takes 9 multiplications per factor instead of the
+// 27 that composing two factors takes, and each step rounds only once. If the same factor appears
+// twice in a chain that is applied often, compose it with itself beforehand.
+template<class... M>
+class MatrixChain
+{
+	std::tuple<const M&...> factors;
+
+	template<std::size_t i>
+	[[gnu::always_inline]]
+	void ApplyFrom(Vector3& res, const Vector3& v) const
+	{
+		FusedMul(res, std::get<i>(factors), v);
+
+		if constexpr (i > 0)
+			ApplyFrom<i - 1>(res, res);
+	}
+
+public:
+	constexpr explicit MatrixChain(const M&... factors): factors(factors...) {}
+
+	// res may alias v, but not any of the factors
+	void Apply(Vector3& res, const Vector3& v) const
+	{
+		ApplyFrom<sizeof...(M) - 1>(res, v);
+	}
+
+	// res may alias m, but not any of the factors
+	void Apply(Matrix3x3& res, const Matrix3x3& m) const
+	{
+		Apply(res.c0, m.c0);
+		Apply(res.c1, m.c1);
+		Apply(res.c2, m.c2);
+	}
+
+	[[gnu::always_inline]]
+	auto operator()(const Vector3& v) const
+	{
+		return Vector3::Proxy([this, &v]<bool resMayAlias> [[gnu::always_inline]] (Vector3& res)
+		{
+			Apply(res, v);
+		});
+	}
+};
+
+// Sets res to the Q24 derivative of v / |v| in the direction dir,
+// which is the component of dir perpendicular to v divided by |v|
+void CalculateNormalizedDerivative(Vector3& res, const Vector3& v, const Vector3& dir);
+
+// The smallest rotation that takes the unit vector u to the unit vector w, kept as the
+// unnormalized quaternion (1 + u.Dot(w), u.Cross(w)) so that rotating several vectors
+// by it only divides once. Assumes that u.Dot(w) > -0.5_f24
+class RotationBetween
+{
+	Vector3_Q24 k;
+	Fix24i invScalar;
+
+public:
+	RotationBetween(const Vector3_Q24& u, const Vector3_Q24& w);
+
+	void Apply(Vector3& v) const;
+};
+
 void CalculateSomeOrthonormalVec(Vector3& res, const Vector3& v);
 
 inline auto GetSomeOrthonormalVec(const Vector3& v)
@@ -562,20 +788,14 @@ inline short& ConvertAngle(short& angle, const Matrix3x3& fromBasis, const Matri
 	return angle += GetAngleOffset(fromBasis.c2, toBasis.c0, toBasis.c2);
 }
 
-inline Fix24i SinQ24(short a)
+constexpr Fix24i SinQ24(short a)
 {
 	return CosQ24(90_deg - a);
 }
 
-class Sqaerp // "spherical quadratically adaptive interpolation"
-{
-	short angularVel = 0;
-public:
-	// returns the new angle
-	int operator()(Vector3_Q24& v, const Vector3_Q24& target, short angularAccel, bool brake = false, int maxAngle = 0x8000);
-
-	constexpr void Reset() & { angularVel = 0; }
-};
+// Same results as SinQ24 and CosQ24 (except for the sign of the
+// tiny sine of -180°), but shares the work between the two
+void SinCosQ24(Fix24i& sine, Fix24i& cosine, short a);
 
 template<std::bidirectional_iterator Iter>
 void InsertionSort(Iter begin, Iter end, auto&& cmp)
@@ -0,0 +1,19 @@
+#pragma once
+#include "SM64DS_PI.h"
+
+// While a batch exists, the collision queries of its actor (RaycastLine::DetectClsn and
+// SphereClsn::DetectClsn) share one lookup of the actor's gravity space, and they are rotated
+// back into world space together when the batch ends instead of after each query. Until then,
+// their positions are in the gravity space of the actor, but all other results are final.
+// A batch that is created while another one exists does nothing.
+class ClsnBatch
+{
+	bool owner;
+
+public:
+	explicit ClsnBatch(Actor& actor);
+	~ClsnBatch();
+
+	ClsnBatch(const ClsnBatch&) = delete;
+	ClsnBatch& operator=(const ClsnBatch&) = delete;
+};
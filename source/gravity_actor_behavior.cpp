@@ -11,7 +11,7 @@ void RedirectDelta(Actor& actor, ActorExtension& extension)
 	if (!extension.ShouldBeTransformed())
 		return;
 
-	actor.pos.RotateAround(extension.savedPos, extension.GetGravityMatrix());
+	FusedRotateAround(actor.pos, extension.savedPos, extension.GetGravityMatrix());
 	extension.savedPos = actor.pos;
 }
 
@@ -54,6 +54,11 @@ void nsub_02010fc8(Actor& actor, unsigned vfSuccess)
 
 #ifdef GRAVITY_DEBUG_COUNTERS
 extern unsigned behaviorTransformCounter;
+extern unsigned gravityUpdateTicks;
+extern unsigned gravityUpdateCalls;
+
+// The OS tick timer of the SDK (timer 0), which counts every 64 bus cycles
+static volatile const u16& osTickTimer = *reinterpret_cast<volatile const u16*>(0x04000100);
 #endif
 
 static void ProcessBehaviorProperties(Actor& actor, bool beforeBehavior)
@@ -61,8 +66,19 @@ static void ProcessBehaviorProperties(Actor& actor, bool beforeBehavior)
 	ActorExtension& extension = ActorExtension::Get(actor);
 
 	if (beforeBehavior)
+	{
+#ifdef GRAVITY_DEBUG_COUNTERS
+		const u16 tick0 = osTickTimer;
+#endif
+
 		extension.UpdateGravity();
 
+#ifdef GRAVITY_DEBUG_COUNTERS
+		gravityUpdateTicks += static_cast<u16>(osTickTimer - tick0);
+		++gravityUpdateCalls;
+#endif
+	}
+
 	static constinit bool shouldTransformOthers;
 
 	if (beforeBehavior)
@@ -140,6 +156,9 @@ Fix12i ApplyNormalAcceleration(const Actor& actor)
 
 	const Vector3& pos = extension.GetLastUpdatePoint();
 
+	if (!extension.IsInFieldTransition())
+		return res + extension.GetGravityField().GetNormalAcceleration(pos, v);
+
 	const Vector3_Q24 u = Vector3_Q24::Raw(fieldMatrix.c1).Normalized();
 
 	Vector3_Q24 w;
@@ -161,6 +180,9 @@ repl_020110ac:
 	b       SetCamSpacePos
 )");
 
+// The game culls actors with a sphere of radius rangeAsr3 around camSpacePos, which doesn't depend on the
+// orientation of the actor. Moving its center along the up vector of the actor instead of the world y-axis
+// (the hook at 02011088 removes the vanilla offset) is enough to make the culling volume field-aligned.
 extern "C" void SetCamSpacePos(Vector3& v, const Matrix4x3& vietMat, Actor& actor)
 {
 	v += (actor.rangeOffsetY >> 3) * ActorExtension::Get(actor).GetUpVectorQ12();
@@ -226,7 +248,7 @@ extern "C" bool AfterShowMessage2(Player& player)
 		const Matrix3x3& actorMatrix = ActorExtension::Get(*behavingActor).GetGravityMatrix();
 
 		player.unk744 = playerExtension.GetRealValue<&Actor::pos>()
-			+ playerMatrix.Transpose()(actorMatrix(player.unk744 - player.pos));
+			+ MatrixChain(playerMatrix.Transpose(), actorMatrix)(player.unk744 - player.pos);
 	}
 
 	return true;
@@ -1,4 +1,5 @@
 #include "gravity_actor_extension.h"
+#include "gravity_cam_ctrl.h"
 
 asm(R"(
 @ at the beginning of Actor::Spawn
@@ -78,11 +79,59 @@ void DestructExtension(const Actor& actor)
 	ActorExtension::Get(actor).~ActorExtension();
 }
 
-int ActorExtension::CalculateUpVector(Vector3_Q24& __restrict__ res, const Vector3& pos, Sqaerp& sqaerp) const
+static Vector3 GetUpVector(const Quaternion& frame)
 {
-	AssureUnaliased(res) = Vector3_Q24::Raw(currMatrix.c1).NormalizedTwice();
+	return frame.RotateSafe(Vector3::Temp(0._f, 1._f, 0._f));
+}
+
+// A field transition turns the whole frame of the actor as a quaternion: from the frame it had when it
+// entered the field to that frame turned by the smallest rotation onto the up vector of the field at pos.
+// The angle accelerates by 1° per frame squared until halfway and decelerates the same way after that.
+// Returns the remaining angle, which is 0 once the transition is finished.
+int ActorExtension::CalculateTransitionFrame(Quaternion& res, const Vector3& pos, unsigned frame) const
+{
+	const Vector3 up0 = GetUpVector(transitionStart);
+	const Vector3 up1 = GetGravityField().GetUpVectorQ12(pos);
+
+	Vector3 axis = up0.Cross(up1);
+	const int angle = Atan2(axis.Len(), up0.Dot(up1)) & 0xffff;
+
+	// The whole rotation takes 2 sqrt(angle / accel) frames, so the elapsed
+	// fraction of it is t = frame sqrt(accel / (4 angle)), which is at least 1 when
+	// frame^2 accel >= 4 angle. The fraction of the angle turned after t is 2t^2
+	// until halfway and 1 - 2(1 - t)^2 after that.
+	constexpr int angularAccel = 1_deg;
+	const int frameSqAccel = frame * frame * angularAccel;
+	int turned = angle;
+
+	if (frameSqAccel < angle << 2)
+	{
+		const Fix24i t = Sqrt(Fix24i(DivQ24(frameSqAccel, angle << 2), as_raw));
+		const Fix24i s = 1._f24 - t;
+		const Fix24i fraction = t < 0.5_f24 ? t*t + t*t : 1._f24 - s*s - s*s;
+
+		turned = static_cast<int64_t>(fraction.val) * angle >> 24;
+	}
+
+	if (axis.Dot(axis) < 0.001_f)
+		CalculateSomeOrthonormalVec(axis, up0);
+	else
+		axis.Normalize();
+
+	const short halfAngle = turned >> 1;
+	res = Quaternion(Cos(halfAngle), Sin(halfAngle) * axis) * transitionStart;
+
+	return angle - turned;
+}
+
+int ActorExtension::PredictNextUpVector(Vector3_Q24& __restrict__ res, const Vector3& nextPos) const
+{
+	Quaternion frame;
+	const int angle = CalculateTransitionFrame(frame, nextPos, transitionFrame + 1);
+
+	res = Vector3_Q24::Raw(GetUpVector(frame)).Normalized();
 
-	return sqaerp(res, GetGravityField().GetUpVectorQ24(pos), 1_deg, false, angleToNewField);
+	return angle;
 }
 
 static Actor& GetHoldingActor(Actor& actor)
@@ -93,6 +142,88 @@ static Actor& GetHoldingActor(Actor& actor)
 		return actor;
 }
 
+// In a slowly varying field, rotating the basis by the smallest rotation that takes prevUp to the
+// new up vector is much cheaper than building a new basis. Returns false if the basis should be
+// rebuilt instead, because the rotation is too large or the rounding errors have added up.
+bool ActorExtension::RotateBasis(const Vector3& prevUp)
+{
+	if (numBasisRotations >= maxBasisRotations)
+		return false;
+
+	const Vector3_Q24 u {prevUp};
+	const Vector3_Q24 w {currMatrix.c1};
+
+	if (u.Dot(w) < 0.5_f24)
+		return false;
+
+	const RotationBetween rotation {u, w};
+	rotation.Apply(currMatrix.c0);
+	rotation.Apply(currMatrix.c2);
+
+	const int drift = std::abs(currMatrix.c0.Dot(currMatrix.c1).val) + std::abs(currMatrix.c2.Dot(currMatrix.c1).val);
+
+	if (drift > maxBasisDrift)
+		return false;
+
+	++numBasisRotations;
+
+	return true;
+}
+
+unsigned ActorExtension::GetLodBand() const
+{
+	const Actor& actor = GetActor();
+	const Player* player = PLAYER_ARR[0];
+
+	if (!player || &actor == player || angleToNewField != 0 || (actor.flags & Actor::IN_PLAYER_HAND))
+		return 0;
+
+	// The largest coordinate difference is close enough to the distance and can't overflow
+	const Vector3 d = actor.pos - player->pos;
+	const Fix12i dist = {std::max({std::abs(d.x.val), std::abs(d.y.val), std::abs(d.z.val)}), as_raw};
+
+	unsigned band = 0;
+	while (band < std::size(lodBandDists) && dist >= lodBandDists[band])
+		++band;
+
+	return band;
+}
+
+#ifdef GRAVITY_DEBUG_COUNTERS
+extern unsigned gravityUpdateCounters[ActorExtension::numLodBands];
+#endif
+
+// On the frames that a distant actor skips, its up vector is predicted from the derivative of the field
+// along the movement since the last prediction, and the basis is rotated to it like in a full update
+void ActorExtension::ExtrapolateBasis(const Vector3& pos)
+{
+	const Vector3 step = pos - extrapolationPoint;
+
+	if (step.Dot(step) < 1._f || IsInTrivialField() || GetGravityField().IsHomogeneous())
+		return;
+
+	const Matrix3x3 prevMatrix = currMatrix;
+	++matrixVersion;
+
+	Vector3_Q24 up = Vector3_Q24::Raw(currMatrix.c1 << 12);
+	up += GetGravityField().GetUpVectorDerivativeQ24(extrapolationPoint, step);
+
+	currMatrix.c1 = up.data.NormalizedTwice();
+
+	if (!RotateBasis(prevMatrix.c1))
+	{
+		currMatrix.c2 = currMatrix.c0.Cross(currMatrix.c1).NormalizedTwice();
+		currMatrix.c0 = currMatrix.c1.Cross(currMatrix.c2).NormalizedTwice();
+		numBasisRotations = 0;
+	}
+
+	Actor& actor = GetActor();
+	ConvertAngle(actor.ang.y, prevMatrix, currMatrix);
+	ConvertAngle(actor.motionAng.y, prevMatrix, currMatrix);
+
+	extrapolationPoint = pos;
+}
+
 void ActorExtension::UpdateGravity()
 {
 	Actor& actor = GetActor();
@@ -101,57 +232,102 @@ void ActorExtension::UpdateGravity()
 	if (delta.Dot(delta) < 1._f && angleToNewField == 0)
 		return;
 
+	Actor& holdingActor = GetHoldingActor(actor);
+	GravityField* found = nullptr;
+	bool fieldChanged = false;
+
+	// The field is checked on every frame, so that actors of all bands enter new fields right away
 	if (!AlwaysInDefaultField())
 	{
-		Actor& holdingActor = GetHoldingActor(actor);
-		auto& found = GravityField::GetFieldAt(holdingActor.pos);
-		const bool fieldChanged = found.GetPriority() >= 0 && &found != &GetGravityField();
+		found = &GravityField::GetFieldAt(holdingActor.pos);
+		fieldChanged = found->GetPriority() >= 0 && found != &GetGravityField();
+	}
+
+	// Distant actors only extrapolate their basis on the frames they skip, and since lastUpdatePoint
+	// stays where it was, the next update catches up with the whole movement.
+	// The unique ID spreads the updates of each band evenly across the frames.
+	const unsigned band = fieldChanged ? 0 : GetLodBand();
+	extern unsigned frameCounter;
+
+	if ((frameCounter + actor.uniqueID) & ((1u << band) - 1))
+	{
+		if (!AlwaysInDefaultField())
+			ExtrapolateBasis(actor.pos);
 
+		return;
+	}
+
+#ifdef GRAVITY_DEBUG_COUNTERS
+	++gravityUpdateCounters[band];
+#endif
+
+	if (!AlwaysInDefaultField())
+	{
 		if (fieldChanged)
 		{
 			GetGravityField().GetActorList().Remove(*this);
-			found.GetActorList().Insert(*this);
-			SetGravityField(found);
+			found->GetActorList().Insert(*this);
+			SetGravityField(*found);
 
-			fieldSqaerp.Reset();
+			Quaternion_FromMatrix3x3(transitionStart, currMatrix, Quaternion(1));
+			transitionFrame = 0;
 			angleToNewField = 180_deg;
 		}
 
 		if (fieldChanged || !GetGravityField().IsHomogeneous() || angleToNewField > 0)
 		{
 			const Matrix3x3 prevMatrix = currMatrix;
+			++matrixVersion;
 
 			Vector3_Q24 currUpVector;
-			angleToNewField = CalculateUpVector(currUpVector, holdingActor.pos, fieldSqaerp);
+			Quaternion frame;
+			const bool inTransition = angleToNewField > 0;
+
+			if (inTransition)
+			{
+				transitionFrame = std::min(transitionFrame + 1, 0xff);
+				angleToNewField = CalculateTransitionFrame(frame, holdingActor.pos, transitionFrame);
+				currUpVector = Vector3_Q24::Raw(GetUpVector(frame)).Normalized();
+			}
+			else
+				currUpVector = GetGravityField().GetUpVectorQ24(holdingActor.pos);
 
 			if (IsInTrivialField())
 				currMatrix = Matrix3x3::Identity();
 			else
 			{
 				currMatrix.c1 = currUpVector.data.NormalizedTwice();
+				bool rebuildBasis = true;
 
 				if (actor.actorID == 0xbf)
 				{
 					if (static_cast<const Player&>(actor).currState == &Player::ST_FIRST_PERSON)
 					{
-						lastUpdatePoint = actor.pos;
+						lastUpdatePoint = extrapolationPoint = actor.pos;
 						return;
 					}
 
 					// This makes the controls of the player feel more accurate and responsive.
 					// The difference may not be noticable to an inexperienced player.
-					SphericalForwardField (
-						currMatrix.c2,
-						static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c0),
-						static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c2),
-						currUpVector
-					);
+					viewContext.CalculateForwardField(currMatrix.c2, currUpVector);
 				}
+				else if (inTransition)
+				{
+					currMatrix = Matrix3x3::FromQuaternion(frame);
+					numBasisRotations = 0;
+					rebuildBasis = false;
+				}
+				else if (RotateBasis(prevMatrix.c1))
+					rebuildBasis = false;
 				else
 					currMatrix.c2 = currMatrix.c0.Cross(currMatrix.c1);
 
-				currMatrix.c2.NormalizeTwice();
-				currMatrix.c0 = currMatrix.c1.Cross(currMatrix.c2).NormalizedTwice();
+				if (rebuildBasis)
+				{
+					currMatrix.c2.NormalizeTwice();
+					currMatrix.c0 = currMatrix.c1.Cross(currMatrix.c2).NormalizedTwice();
+					numBasisRotations = 0;
+				}
 			}
 
 			ConvertAngle(actor.ang.y, prevMatrix, currMatrix);
@@ -159,5 +335,5 @@ void ActorExtension::UpdateGravity()
 		}
 	}
 
-	lastUpdatePoint = actor.pos;
+	lastUpdatePoint = extrapolationPoint = actor.pos;
 }
\ No newline at end of file
@@ -161,6 +161,9 @@ constinit unsigned cylClsnUpdateCounter = 0;
 constinit unsigned behaviorTransformCounter = 0;
 constinit unsigned activeActorCounter = 0;
 constinit unsigned bgChTransformCounter = 0;
+constinit unsigned gravityUpdateCounters[ActorExtension::numLodBands] = {};
+constinit unsigned gravityUpdateTicks = 0;
+constinit unsigned gravityUpdateCalls = 0;
 #endif
 
 void CamCtrl::Update(Camera& cam, Player& player)
@@ -171,10 +174,21 @@ void CamCtrl::Update(Camera& cam, Player& player)
 	ShowDecimalInt(activeActorCounter, 10, 70);
 	ShowDecimalInt(bgChTransformCounter, 10, 100);
 
+	for (unsigned i = 0; i < ActorExtension::numLodBands; i++)
+	{
+		ShowDecimalInt(gravityUpdateCounters[i], 60, 10 + 30*i);
+		gravityUpdateCounters[i] = 0;
+	}
+
+	// The average number of CPU cycles per UpdateGravity, since a tick is 64 bus cycles or 128 CPU cycles
+	ShowDecimalInt(gravityUpdateCalls ? (gravityUpdateTicks << 7) / gravityUpdateCalls : 0, 110, 10);
+
 	cylClsnUpdateCounter = 0;
 	behaviorTransformCounter = 0;
 	activeActorCounter = 0;
 	bgChTransformCounter = 0;
+	gravityUpdateTicks = 0;
+	gravityUpdateCalls = 0;
 #endif
 
 	CheckFieldChange(cam, player);
@@ -231,6 +245,47 @@ void CamCtrl::Update(Camera& cam, Player& player)
 	SetCamMatrix(cam, std::move(currTransform));
 }
 
+// Incremented once per frame when the view matrices are set
+constinit unsigned frameCounter = 0;
+
+constinit ViewContext viewContext;
+
+void ViewContext::Update()
+{
+	camXAxis = Vector3_Q24(INV_VIEW_MATRIX_ASR_3.c0);
+	camYAxis = Vector3_Q24(INV_VIEW_MATRIX_ASR_3.c1);
+	camZAxis = Vector3_Q24(INV_VIEW_MATRIX_ASR_3.c2);
+
+	skyBoxMatrix.Linear() = VIEW_MATRIX_ASR_3.Linear();
+	forwardFieldValid = false;
+}
+
+void ViewContext::CalculateForwardField(Vector3& __restrict__ res, const Vector3_Q24& up)
+{
+	const int upDiff =
+		std::abs(up.data.x.val - forwardFieldUp.data.x.val) +
+		std::abs(up.data.y.val - forwardFieldUp.data.y.val) +
+		std::abs(up.data.z.val - forwardFieldUp.data.z.val);
+
+	if (!forwardFieldValid || upDiff > maxForwardFieldUpDiff)
+	{
+		SphericalForwardField(forwardField, camXAxis, camZAxis, up);
+		forwardFieldUp = up;
+		forwardFieldValid = true;
+
+		res = forwardField;
+		return;
+	}
+
+	// The remembered result belongs to a slightly different up vector, so the component along
+	// this one is removed again, since the callers build the rest of the basis by crossing with up
+	Vector3 proj;
+	Vector3_Q24::Multiply(proj, up.data, Vector3_Q24::CalculateDot(forwardField, up.data));
+
+	res = forwardField - proj;
+	Vector3_Q24::NormalizeInPlace(res);
+}
+
 // Change the camera matrix before the view matrices are set
 void repl_0200de68(Camera& cam)
 {
@@ -238,6 +293,8 @@ void repl_0200de68(Camera& cam)
 		CamCtrl::Update(cam, static_cast<Player&>(*cam.owner));
 
 	cam.View::Render();
+	viewContext.Update();
+	++frameCounter;
 }
 
 asm(R"(
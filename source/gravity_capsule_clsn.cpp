@@ -0,0 +1,270 @@
+#include "gravity_capsule_clsn.h"
+
+[[gnu::always_inline]]
+static inline Fix12i MulQ24(Fix12i x, Fix24i t)
+{
+	return {(Fix24i(x, as_raw) * t).val, as_raw};
+}
+
+// Returns the distance from u0 along the unit vector dir to the point where the ray
+// enters the unit sphere, or a negative number if the ray doesn't enter it from the outside.
+// Also works for the unit cylinder when u0 and dir are perpendicular to its axis.
+static Fix12i EnterUnitSphere(const Vector3& u0, const Vector3& dir)
+{
+	const Fix12i b = u0.Dot(dir);
+
+	// u0 is in units of the radius, so it can be far too long to square in Q12 when the
+	// collider is long and thin or the ray is long. The squares are kept in Q24 in 64 bits.
+	const int64_t lenSq =
+		int64_t(u0.x.val) * u0.x.val +
+		int64_t(u0.y.val) * u0.y.val +
+		int64_t(u0.z.val) * u0.z.val;
+
+	constexpr int64_t oneQ24 = int64_t(1) << 24;
+
+	if (lenSq <= oneQ24 || b >= 0_f)
+		return -1._f;
+
+	// The squared distance from the center to the line, which is at most 1 if the line hits the sphere
+	const int64_t distSq = lenSq - int64_t(b.val) * b.val;
+
+	if (distSq > oneQ24)
+		return -1._f;
+
+	return -b - Sqrt(1._f - Fix12i(int(distSq >> 12), as_raw));
+}
+
+CapsuleClsn::CapsuleClsn(const Vector3& p0, const Vector3& p1, Fix12i radius, bool flatCaps, const CLPS& clps):
+	p0(p0),
+	axis((p1 - p0).Normalized()),
+	length(p0.Dist(p1)),
+	radius(radius),
+	invRadius(Fix24i(1._f, as_raw) / Fix24i(radius, as_raw)), // multiplying a Fix12i by this divides it by the radius
+	clps(clps),
+	flatCaps(flatCaps)
+{}
+
+bool CapsuleClsn::CanIntersect(const Vector3& pos, Fix12i dist) const
+{
+	const Fix12i halfLength = length >> 1;
+
+	return (p0 + axis * halfLength).Dist(pos) <= halfLength + radius + dist;
+}
+
+Fix12i CapsuleClsn::CalculateSignedDist(Vector3& normal, const Vector3& pos) const
+{
+	const Vector3 relPos = pos - p0;
+	const Fix12i a = axis.Dot(relPos);
+
+	if (!flatCaps)
+	{
+		normal = relPos - axis * std::clamp(a, 0_f, length);
+
+		const Fix12i dist = normal.Len();
+
+		if (dist > 0_f)
+			normal /= dist;
+		else
+			normal = GetSomeOrthonormalVec(axis);
+
+		return dist - radius;
+	}
+
+	Vector3 radial = relPos - axis * a;
+	const Fix12i distToAxis = radial.Len();
+
+	if (distToAxis > 0_f)
+		radial /= distToAxis;
+	else
+		radial = GetSomeOrthonormalVec(axis);
+
+	const bool closerToBottom = a < (length >> 1);
+	const Fix12i sideDist = distToAxis - radius;
+	const Fix12i capDist = closerToBottom ? -a : a - length;
+	const Vector3 capNormal = axis * (closerToBottom ? -1._f : 1._f);
+
+	if (capDist <= 0_f && (sideDist > capDist || sideDist > 0_f))
+	{
+		normal = radial;
+		return sideDist;
+	}
+
+	if (sideDist <= 0_f)
+	{
+		normal = capNormal;
+		return capDist;
+	}
+
+	// The closest point is on the rim of a cap
+	normal = radial * sideDist + capNormal * capDist;
+
+	const Fix12i dist = normal.Len();
+	normal /= dist;
+
+	return dist;
+}
+
+// Returns the point where the ray enters the collider as a Q24
+// fraction of dir, or a negative number if there's no such point
+Fix24i CapsuleClsn::FindEntry(const Vector3& pos0, const Vector3& dir) const
+{
+	const Vector3 relPos = pos0 - p0;
+	const Fix12i a0 = axis.Dot(relPos);
+	const Fix12i ad = axis.Dot(dir);
+
+	// Since the collider is convex, any point where the ray enters its surface is the only one
+	Vector3 radialDir = dir - axis * ad;
+
+	if (const Fix12i radialLen = radialDir.Len(); radialLen > 0_f)
+	{
+		radialDir /= radialLen;
+
+		Vector3 u0 = relPos - axis * a0;
+		Vector3_Q24::Multiply(u0, u0, invRadius);
+
+		if (const Fix12i dist = EnterUnitSphere(u0, radialDir); dist >= 0_f)
+		{
+			const Fix12i entryDist = dist * radius;
+
+			if (entryDist <= radialLen)
+			{
+				const Fix24i t = Fix24i(entryDist, as_raw) / Fix24i(radialLen, as_raw);
+				const Fix12i a = a0 + MulQ24(ad, t);
+
+				if (0_f <= a && a <= length)
+					return t;
+			}
+		}
+	}
+
+	if (flatCaps)
+	{
+		Fix12i distToCap;
+
+		if (a0 < 0_f && ad > 0_f)
+			distToCap = -a0;
+		else if (a0 > length && ad < 0_f)
+			distToCap = length - a0;
+		else
+			return -1._f24;
+
+		const Fix24i t = Fix24i(distToCap, as_raw) / Fix24i(ad, as_raw);
+
+		if (t > 1._f24)
+			return -1._f24;
+
+		Vector3 hitPos;
+		Vector3_Q24::Multiply(hitPos, dir, t);
+		hitPos += relPos;
+
+		if ((hitPos - axis * axis.Dot(hitPos)).Len() <= radius)
+			return t;
+
+		return -1._f24;
+	}
+
+	const Fix12i dirLen = dir.Len();
+
+	if (dirLen == 0_f)
+		return -1._f24;
+
+	Vector3 dirUnit = dir;
+	dirUnit /= dirLen;
+
+	for (const Fix12i capA : {0_f, length})
+	{
+		Vector3 u0 = relPos - axis * capA;
+		Vector3_Q24::Multiply(u0, u0, invRadius);
+
+		const Fix12i dist = EnterUnitSphere(u0, dirUnit);
+		if (dist < 0_f) continue;
+
+		const Fix12i entryDist = dist * radius;
+		if (entryDist > dirLen) continue;
+
+		const Fix24i t = Fix24i(entryDist, as_raw) / Fix24i(dirLen, as_raw);
+		const Fix12i a = a0 + MulQ24(ad, t);
+
+		if (capA == 0_f ? a <= 0_f : a >= length)
+			return t;
+	}
+
+	return -1._f24;
+}
+
+bool CapsuleClsn::Raycast(Vector3& clsnPos, Vector3& normal, const Vector3& pos0, const Vector3& pos1) const
+{
+	const Vector3 dir = pos1 - pos0;
+
+	if (!CanIntersect(pos0, dir.Len()))
+		return false;
+
+	const Fix24i t = FindEntry(pos0, dir);
+
+	if (t < 0._f24)
+		return false;
+
+	Vector3_Q24::Multiply(clsnPos, dir, t);
+	clsnPos += pos0;
+
+	CalculateSignedDist(normal, clsnPos);
+
+	return true;
+}
+
+bool CapsuleClsn::CalculatePushback(Vector3& res, Vector3& normal, const Vector3& center, Fix12i sphereRadius) const
+{
+	const Fix12i dist = CalculateSignedDist(normal, center);
+
+	if (dist >= sphereRadius)
+		return false;
+
+	res = normal * (sphereRadius - dist);
+
+	return true;
+}
+
+const CapsuleClsn* CapsuleClsn::RaycastAll(Vector3& clsnPos, Vector3& normal, const Vector3& pos0, const Vector3& pos1)
+{
+	const CapsuleClsn* res = nullptr;
+	Vector3 end = pos1;
+
+	// Each hit shortens the ray, so only the closest hit remains in the end
+	for (const CapsuleClsn* clsn = GetFirst(); clsn; clsn = clsn->next)
+	{
+		if (clsn->Raycast(clsnPos, normal, pos0, end))
+		{
+			end = clsnPos;
+			res = clsn;
+		}
+	}
+
+	return res;
+}
+
+const CapsuleClsn* CapsuleClsn::CalculatePushbackAll(Vector3& res, Vector3& normal, const Vector3& center, Fix12i sphereRadius)
+{
+	const CapsuleClsn* found = nullptr;
+	Fix12i maxPushbackLen = 0_f;
+	Vector3 pos = center;
+	Vector3 pushback, pushbackNormal;
+
+	for (const CapsuleClsn* clsn = GetFirst(); clsn; clsn = clsn->next)
+	{
+		if (clsn->CalculatePushback(pushback, pushbackNormal, pos, sphereRadius))
+		{
+			pos += pushback;
+
+			if (const Fix12i len = pushback.Len(); !found || len > maxPushbackLen)
+			{
+				maxPushbackLen = len;
+				normal = pushbackNormal;
+				found = clsn;
+			}
+		}
+	}
+
+	res = pos - center;
+
+	return found;
+}
@@ -24,13 +24,14 @@ inline void SetScalarAt(void* base, std::size_t index, T val)
 	);
 }
 
-template<FixUR T> struct Fix30 : Fix<T, 30, Fix30> { using Fix<T, 30, Fix30>::Fix; };
-using Fix30i = Fix30<int>;
-
-// Assumes that u.Dot(w) > -0.5_f
-static void MakeRotationBetween(Matrix3x3& res, const Vector3& u, const Vector3& w)
+// Sets res to the square of the smallest rotation that takes the unit vector u to the unit vector w.
+// With k = u.Cross(w) and c = u.Dot(w), that rotation is I + K + K^2 / (1 + c) where K is the cross
+// product matrix of k, and its square simplifies to I + 2cK + 2K^2, which needs no division.
+// Assumes that u.Dot(w) > 0_f
+static void MakeDoubleRotationBetween(Matrix3x3& res, const Vector3& u, const Vector3& w)
 {
 	const Vector3 k = u.Cross(w);
+	const Fix12i c2 = u.Dot(w) << 1;
 
 	const Matrix3x3 generator
 	{
@@ -41,14 +42,12 @@ static void MakeRotationBetween(Matrix3x3& res, const Vector3& u, const Vector3&
 
 	res = generator(generator);
 
-	const Fix30i d = {(Fix12i(Fix30i(1), as_raw) / (1._f + u.Dot(w))).val, as_raw};
-
 	for (int i = 0; i < 9; i++)
 	{
-		Fix12i a = {d * GetScalarAt<Fix30i>(&res, i), as_raw};
+		Fix12i a = GetScalarAt<Fix12i>(&res, i) << 1;
 
 		if (i & 3) // if not on the diagonal
-			a += GetScalarAt<Fix12i>(&generator, i);
+			a += c2 * GetScalarAt<Fix12i>(&generator, i);
 		else
 			a += 1._f;
 
@@ -65,7 +64,7 @@ struct CylClsnData
 	const Matrix3x3* fixedCylClsnGravity;
 
 	Vector3 movedCylClsnPos; // position of the cylinder collider updated in the inner loop
-	Matrix3x3 alignRotation; // used to align the cylinder colliders with each other
+	Matrix3x3 alignRotation; // rotates the up vector of the moved collider to that of the fixed one
 
 private:
 	static constexpr std::size_t ogAllocSize = 0x14;
@@ -140,11 +139,13 @@ extern "C" Vector3& AlignCylColliders(CylinderClsn& movedCylClsn, CylClsnData& d
 		const Matrix3x3& g1 = *data.movedCylClsnGravity;
 		const Matrix3x3& g2 = *data.fixedCylClsnGravity;
 
-		MakeRotationBetween(data.alignRotation, g1.c1, (g1.c1 + g2.c1).Normalized());
+		// Going through the halfway vector keeps the rotation accurate when the up vectors are far apart
+		MakeDoubleRotationBetween(data.alignRotation, g1.c1, (g1.c1 + g2.c1).Normalized());
 
-		const Matrix3x3& r = data.alignRotation;
+		Vector3& pos = data.movedCylClsnPos;
 
-		data.movedCylClsnPos = g2.Transpose()(r(r(g1(data.movedCylClsnPos - *p1)) + *p1 - *p2)) + *p2;
+		pos = MatrixChain(data.alignRotation, g1)(pos - *p1) + *p1;
+		FusedRotateAround(pos, *p2, g2.Transpose());
 	}
 	else
 		data.movedCylClsnGravity = nullptr;
@@ -160,9 +161,7 @@ extern "C" void TransformPushback(CylinderClsn& movedCylClsn, CylClsnData& data)
 		const Matrix3x3& g1 = *data.movedCylClsnGravity;
 		const Matrix3x3& g2 = *data.fixedCylClsnGravity;
 
-		const auto invR = data.alignRotation.Transpose();
-
-		movedCylClsn.pushback = g1.Transpose()(invR(invR(g2(movedCylClsn.pushback))));
+		MatrixChain(g1.Transpose(), data.alignRotation.Transpose(), g2).Apply(movedCylClsn.pushback, movedCylClsn.pushback);
 	}
 }
 
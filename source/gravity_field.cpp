@@ -1,4 +1,5 @@
 #include "gravity_actor_extension.h"
+#include "gravity_capsule_clsn.h"
 #include "gravity_fields/trivial_field.h"
 #include "gravity_fields/radial_field.h"
 #include "gravity_fields/axial_field.h"
@@ -120,6 +121,31 @@ public:
 			return nullptr;
 	}
 
+	virtual void CalculateUpVectorDerivativeQ24(Vector3& res, const Vector3& pos, const Vector3& dir) const final override
+	{
+		if constexpr (homogeneous)
+			res.x = res.y = res.z = 0_f;
+		else
+			Base::CalculateUpVectorDerivative(res, pos, dir);
+	}
+
+	// The acceleration towards the field that keeps an actor moving at
+	// velocity vel at the same altitude, which follows from the curvature
+	virtual Fix12i GetNormalAcceleration(const Vector3& pos, const Vector3& vel) const final override
+	{
+		if constexpr (homogeneous)
+			return 0_f;
+		else if constexpr (requires(const Base& base) { base.GetNormalAcceleration(pos, vel); })
+			return Base::GetNormalAcceleration(pos, vel);
+		else
+		{
+			Vector3 derivative;
+			Base::CalculateUpVectorDerivative(derivative, pos, vel);
+
+			return {Vector3_Q24::CalculateDot(vel, derivative).val, as_raw};
+		}
+	}
+
 	virtual Fix12i GetAltitude(const Vector3& pos) const final override
 	{
 		if constexpr (requires { Base::GetAltitude(pos); })
@@ -181,6 +207,7 @@ struct FieldGenerator
 {
 	uintptr_t sizeCounter;
 	GravityField** nextPtr;
+	CapsuleClsn** nextClsnPtr;
 
 	template<class F, class... Args>
 	void Spawn(Args&&... args)
@@ -199,12 +226,38 @@ struct FieldGenerator
 		sizeCounter += sizeof(G);
 	}
 
+	template<class... Args>
+	void SpawnClsn(Args&&... args)
+	{
+		static_assert(std::is_trivially_destructible_v<CapsuleClsn>);
+		static_assert(alignof(CapsuleClsn) <= alignof(GravityField));
+
+		if (nextClsnPtr)
+		{
+			std::byte* dest = reinterpret_cast<std::byte*>(sizeCounter);
+			*nextClsnPtr = new (dest) CapsuleClsn (std::forward<Args>(args)...);
+			nextClsnPtr = &(*nextClsnPtr)->next;
+		}
+
+		sizeCounter += sizeof(CapsuleClsn);
+	}
+
+	// The surface of a solid collider is ordinary ground that selects
+	// the planet camera setting of its path (see PlanetCam::UpdateSettings)
+	static CLPS MakeCLPS(PathPtr pathPtr)
+	{
+		CLPS clps {};
+		clps.padding2 = pathPtr->param3;
+
+		return clps;
+	}
+
 	void Generate(PathPtr pathPtr)
 	{
 		const auto numNodes = pathPtr.NumNodes();
 		if (numNodes < 2) return;
 
-		switch (pathPtr->param1 - GravityField::pathBaseParam1)
+		switch ((pathPtr->param1 - GravityField::pathBaseParam1) & ~GravityField::particleGravityFlag)
 		{
 		case 0:
 			if (numNodes == 2)
@@ -232,6 +285,40 @@ struct FieldGenerator
 		case 2:
 			Spawn<TrivialCylinderField>(pathPtr);
 			break;
+		case 3:
+			if (numNodes >= 4)
+			{
+				const unsigned lastAxisNodeID = numNodes - 3;
+				const Vector3 lastAxisNode = pathPtr.GetNode(lastAxisNodeID);
+				const Fix12i clsnRadius  = lastAxisNode.Dist(pathPtr.GetNode(numNodes - 2));
+				const Fix12i fieldRadius = lastAxisNode.Dist(pathPtr.GetNode(numNodes - 1));
+				const CLPS clps = MakeCLPS(pathPtr);
+
+				Vector3 p0 = pathPtr.GetNode(0);
+
+				for (unsigned i = 1; i <= lastAxisNodeID; ++i)
+				{
+					const Vector3 p1 = pathPtr.GetNode(i);
+					Spawn<AxialField>(pathPtr, p0, p1, fieldRadius);
+					SpawnClsn(p0, p1, clsnRadius, false, clps);
+					p0 = p1;
+				}
+			}
+			break;
+		case 4:
+			if (numNodes >= 4)
+			{
+				Spawn<HomogeneousCylinderField>(pathPtr);
+
+				const Vector3 p0 = pathPtr.GetNode(0);
+				const Vector3 up = (pathPtr.GetNode(1) - p0).Normalized();
+				const Vector3 rimPos = pathPtr.GetNode(2) - p0;
+				const Fix12i radius = rimPos.Dist(rimPos.Dot(up) * up);
+				const Fix12i depth = p0.Dist(pathPtr.GetNode(3));
+
+				SpawnClsn(p0 - up * depth, p0, radius, true, MakeCLPS(pathPtr));
+			}
+			break;
 		}
 	}
 };
@@ -242,6 +329,7 @@ class GravityFieldList
 {
 	std::byte* storage = nullptr;
 	GravityField* root = nullptr;
+	CapsuleClsn* clsnRoot = nullptr;
 
 	[[gnu::target("thumb")]]
 	void Fill()
@@ -261,7 +349,7 @@ class GravityFieldList
 			if (pathPtr->param1 < GravityField::pathBaseParam1)
 				continue;
 
-			FieldGenerator generator = {0, nullptr};
+			FieldGenerator generator = {0, nullptr, nullptr};
 			generator.Generate(pathPtr);
 
 			if (generator.sizeCounter != 0)
@@ -280,7 +368,7 @@ class GravityFieldList
 		});
 
 		storage = new std::byte[size];
-		FieldGenerator generator = {reinterpret_cast<uintptr_t>(storage), &root};
+		FieldGenerator generator = {reinterpret_cast<uintptr_t>(storage), &root, &clsnRoot};
 
 		for (const PathPtr pathPtr : gravityFieldPaths)
 			generator.Generate(pathPtr);
@@ -308,7 +396,8 @@ class GravityFieldList
 public:
 	Iterator begin() { Fill(); return root; }
 	Iterator end() const { return nullptr; }
-	void Clear() { delete[] storage; storage = nullptr; root = nullptr; }
+	const CapsuleClsn* GetFirstClsn() { Fill(); return clsnRoot; }
+	void Clear() { delete[] storage; storage = nullptr; root = nullptr; clsnRoot = nullptr; }
 }
 static constinit fieldList;
 
@@ -317,6 +406,11 @@ void GravityField::Cleanup()
 	fieldList.Clear();
 }
 
+const CapsuleClsn* CapsuleClsn::GetFirst()
+{
+	return fieldList.GetFirstClsn();
+}
+
 GravityField& GravityField::GetFieldFor(const Actor& actor, const ActorList::Node& node)
 {
 	if (node.AlwaysInDefaultField())
@@ -1,5 +1,10 @@
 #include "gravity_math.h"
 
+// The software versions used in constant evaluation
+static_assert(DivQ24(1 << 24, 3 << 24) == 0x555555);
+static_assert(Sqrt(4._f24) == 2._f24);
+static_assert(CosQ24(0) == 1._f24);
+
 void Vector3_Q24::Multiply(Vector3& res, const Vector3& v, Fix24i scalar)
 {
 	res.x.val = (Fix24i(v.x.val, as_raw) * scalar).val;
@@ -7,70 +12,98 @@ void Vector3_Q24::Multiply(Vector3& res, const Vector3& v, Fix24i scalar)
 	res.z.val = (Fix24i(v.z.val, as_raw) * scalar).val;
 }
 
+void Vector3_Q24::NormalizeAsync(Vector3& scaled, const Vector3& v)
+{
+	const auto abs = [](int x) { return x < 0 ? -static_cast<unsigned>(x) : static_cast<unsigned>(x); };
+	const unsigned bits = abs(v.x.val) | abs(v.y.val) | abs(v.z.val);
+
+	// Scale the vector by a power of 2 so that its largest component is in [2^28, 2^29).
+	// Then the length is accurate to about 30 bits, so a single pass is enough, and its
+	// reciprocal fits into a single division, which replaces the three divisions by the length.
+	const int shift = bits ? __builtin_clz(bits) - 3 : 0;
+	const auto scale = [shift](Fix12i x) { return Fix12i(shift >= 0 ? x.val << shift : x.val >> -shift, as_raw); };
+	scaled = {scale(v.x), scale(v.y), scale(v.z)};
+
+	DivQ24Async(1 << 30, LenVec3(scaled)); // 2^54 / len, in (2^24, 2^26]
+}
+
+void Vector3_Q24::NormalizeResult(Vector3& res, const Vector3& scaled)
+{
+	const int64_t recip = DivQ24Result();
+
+	res.x.val = (scaled.x.val * recip + (1 << 29)) >> 30;
+	res.y.val = (scaled.y.val * recip + (1 << 29)) >> 30;
+	res.z.val = (scaled.z.val * recip + (1 << 29)) >> 30;
+}
+
 void Vector3_Q24::CalculateNormalized(Vector3& res, const Vector3& v)
 {
-	const Fix24i mag (v.Len(), as_raw);
-	res.x.val = (Fix24i(v.x, as_raw) / mag).val;
-	res.y.val = (Fix24i(v.y, as_raw) / mag).val;
-	res.z.val = (Fix24i(v.z, as_raw) / mag).val;
+	Vector3 scaled;
+	NormalizeAsync(scaled, v);
+	NormalizeResult(res, scaled);
 }
 
+// The products are accumulated in 64 bits and rounded only once,
+// which lets the compiler chain them with smull and smlal
+
 Fix24i Vector3_Q24::CalculateDot(const Vector3& v0, const Vector3& v1)
 {
-	return Fix24i(v0.x, as_raw) * Fix24i(v1.x, as_raw)
-	     + Fix24i(v0.y, as_raw) * Fix24i(v1.y, as_raw)
-	     + Fix24i(v0.z, as_raw) * Fix24i(v1.z, as_raw);
+	const int64_t acc =
+		  static_cast<int64_t>(v0.x.val) * v1.x.val
+		+ static_cast<int64_t>(v0.y.val) * v1.y.val
+		+ static_cast<int64_t>(v0.z.val) * v1.z.val;
+
+	return {static_cast<int>((acc + (1 << 23)) >> 24), as_raw};
 }
 
 void Vector3_Q24::CalculateCross(Vector3& res, const Vector3& v0, const Vector3& v1)
 {
-	const Fix24i x0(v0.x, as_raw);
-	const Fix24i y0(v0.y, as_raw);
-	const Fix24i z0(v0.z, as_raw);
-	const Fix24i x1(v1.x, as_raw);
-	const Fix24i y1(v1.y, as_raw);
-	const Fix24i z1(v1.z, as_raw);
-
-	res.x.val = (y0 * z1 - z0 * y1).val;
-	res.y.val = (z0 * x1 - x0 * z1).val;
-	res.z.val = (x0 * y1 - y0 * x1).val;
+	const int64_t x0 = v0.x.val;
+	const int64_t y0 = v0.y.val;
+	const int64_t z0 = v0.z.val;
+	const int64_t x1 = v1.x.val;
+	const int64_t y1 = v1.y.val;
+	const int64_t z1 = v1.z.val;
+
+	res.x.val = (y0 * z1 - z0 * y1 + (1 << 23)) >> 24;
+	res.y.val = (z0 * x1 - x0 * z1 + (1 << 23)) >> 24;
+	res.z.val = (x0 * y1 - y0 * x1 + (1 << 23)) >> 24;
 }
 
-void Vector3_Q24::SetMaxAngleToNormalized(const Vector3_Q24& j, short angle)
+void FusedMul(Vector3& res, const Matrix3x3& m, const Vector3& v)
 {
-	const Fix24i dot = this->Dot(j);
-	const Fix24i cosine = CosQ24(angle);
+	const int64_t x = v.x.val;
+	const int64_t y = v.y.val;
+	const int64_t z = v.z.val;
 
-	if (cosine < dot) return;
+	res.x.val = (m.c0.x.val * x + m.c1.x.val * y + m.c2.x.val * z + 0x800) >> 12;
+	res.y.val = (m.c0.y.val * x + m.c1.y.val * y + m.c2.y.val * z + 0x800) >> 12;
+	res.z.val = (m.c0.z.val * x + m.c1.z.val * y + m.c2.z.val * z + 0x800) >> 12;
+}
 
-	*this = ((*this - j * dot).Normalized() * SinQ24(angle) + j * cosine).Normalized();
+void FusedMul(Vector3& res, const Matrix3x3::TransposeProxy& m, const Vector3& v)
+{
+	const Matrix3x3& t = m.Transpose();
+	const int64_t x = v.x.val;
+	const int64_t y = v.y.val;
+	const int64_t z = v.z.val;
+
+	res.x.val = (t.c0.x.val * x + t.c0.y.val * y + t.c0.z.val * z + 0x800) >> 12;
+	res.y.val = (t.c1.x.val * x + t.c1.y.val * y + t.c1.z.val * z + 0x800) >> 12;
+	res.z.val = (t.c2.x.val * x + t.c2.y.val * y + t.c2.z.val * z + 0x800) >> 12;
 }
 
-int Sqaerp::operator()(Vector3_Q24& v, const Vector3_Q24& target, short angularAccel, bool brake, int maxAngle)
+void Vector3_Q24::SetMaxAngleToNormalized(const Vector3_Q24& j, short angle)
 {
-	if (angularAccel <= 0)
-		return false;
-	
-	const int currAngle = std::min<int>(v.AngleTo(target), maxAngle);
-	const int expectedMidAngle = angularVel * angularVel / (angularAccel << 1);
-
-	if (currAngle > expectedMidAngle && !brake)
-		angularVel -= angularAccel;
-	else
-		angularVel = std::min<short>(angularVel + angularAccel, 0);
-	
-	if (-angularVel < currAngle)
-	{
-		const auto newAngle = currAngle + angularVel;
-		v.SetMaxAngleToNormalized(target, newAngle);
+	const Fix24i dot = this->Dot(j);
+	Fix24i sine, cosine;
+	SinCosQ24(sine, cosine, angle);
 
-		return newAngle;
-	}
+	if (cosine < dot) return;
 
-	angularVel = 0;
-	v = target;
+	const Vector3_Q24 perp = (*this - j * dot).Normalized();
 
-	return 0;
+	*this = (perp * sine + j * cosine).Normalized();
 }
 
 consteval uint64_t fac(uint64_t n)
@@ -78,24 +111,17 @@ consteval uint64_t fac(uint64_t n)
 	return n ? n * fac(n - 1) : 1;
 }
 
-Fix24i CosQ24(short a)
+void SinCosQ24(Fix24i& sine, Fix24i& cosine, short a)
 {
-	int b = a;
-	if (b < 0) b = -b;
-	
-	bool flipped;
+	const int b = a < 0 ? -a : a;
+	const int d = 0x4000 - b; // the angle from b to 90°
+	const int absD = d < 0 ? -d : d;
 
-	if (b > 0x4000)
-	{
-		b = 0x8000 - b;
-		flipped = true;
-	}
-	else flipped = false;
-
-	const Fix24i x = {b << 10, as_raw};
-	const Fix24i res = 1._f24 - (0x1'41ff5e_f24 - (0x0'2be0ed_f24*x + 0x0'161e72_f24)*x)*x*x;
+	const Fix24i sineMag = CosFirstQuadrantQ24(absD);
+	const Fix24i cosineMag = CosFirstQuadrantQ24(0x4000 - absD);
 
-	return flipped ? -res : res;
+	sine = a < 0 ? -sineMag : sineMag;
+	cosine = d < 0 ? -cosineMag : cosineMag;
 }
 
 void SphericalForwardField(Vector3& __restrict__ res, const Vector3_Q24& xAxis, const Vector3_Q24& yAxis, const Vector3_Q24& up)
@@ -105,18 +131,70 @@ void SphericalForwardField(Vector3& __restrict__ res, const Vector3_Q24& xAxis,
 
 	if (u.Dot(u) > 0x00'000100_f24)
 	{
-		u.Normalize();
+		Vector3 scaled;
+		Vector3_Q24::NormalizeAsync(scaled, u.data);
+		const Fix24i resLenSq = Vector3_Q24::CalculateDot(res, res);
+		Vector3_Q24::NormalizeResult(u.data, scaled);
 
 		const Fix24i a = Vector3_Q24::CalculateDot(res, u.data);
-		const Fix24i b = a * a - Vector3_Q24::CalculateDot(res, res) + 1._f24;
+		const Fix24i b = a * a - resLenSq + 1._f24;
+
+		SqrtQ24Async(std::max(b, 0._f24));
+		const int sign = Sgn(up.Dot(xAxis));
 
-		u *= Sgn(up.Dot(xAxis)) * Sqrt(std::max(b, 0._f24)) + a;
+		u *= sign * SqrtQ24Result() + a;
 		res -= u.data;
 	}
 
 	Vector3_Q24::NormalizeInPlace(res);
 }
 
+void CalculateNormalizedDerivative(Vector3& res, const Vector3& v, const Vector3& dir)
+{
+	const Fix24i len = {v.Len().val, as_raw};
+
+	if (len == 0._f24)
+	{
+		res.x = res.y = res.z = 0_f;
+		return;
+	}
+
+	Vector3 u;
+	Vector3_Q24::CalculateNormalized(u, v);
+
+	// u is in Q24 and dir is in Q12, so the projection is in Q12
+	Vector3 proj;
+	Vector3_Q24::Multiply(proj, u, Vector3_Q24::CalculateDot(u, dir));
+
+	res = dir - proj;
+	res.x.val = (Fix24i(res.x.val, as_raw) / len).val;
+	res.y.val = (Fix24i(res.y.val, as_raw) / len).val;
+	res.z.val = (Fix24i(res.z.val, as_raw) / len).val;
+}
+
+RotationBetween::RotationBetween(const Vector3_Q24& u, const Vector3_Q24& w)
+{
+	DivQ24Async(1 << 24, (1._f24 + u.Dot(w)).val);
+
+	k = u.Cross(w);
+	invScalar = {DivQ24Result(), as_raw};
+}
+
+// Rodrigues' rotation formula: v + k×v + k×(k×v) / (1 + u·w), where k = u×w,
+// which is what the quaternion does to v without converting it to a matrix
+void RotationBetween::Apply(Vector3& v) const
+{
+	Vector3_Q24 res {v};
+	const Vector3_Q24 kv = k.Cross(res);
+	Vector3_Q24 kkv = k.Cross(kv);
+
+	kkv *= invScalar;
+	res += kv;
+	res += kkv;
+
+	v = res.ToQ12();
+}
+
 // Assumes v is a unit vector
 void CalculateSomeOrthonormalVec(Vector3& res, const Vector3& v)
 {
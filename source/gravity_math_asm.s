@@ -1,5 +1,5 @@
-.global DivQ24
-DivQ24:
+.global DivQ24Async
+DivQ24Async:
 	ldr     r2, =#0x04000280
 	mov     r12, #1
 	strh    r12,[r2]
@@ -8,6 +8,16 @@ DivQ24:
 	str     r0, [r2, #0x14]
 	str     r1, [r2, #0x18]
 	str     r12,[r2, #0x1c]
+	bx      r14
+
+.global HardwareDivQ24
+HardwareDivQ24:
+	push    {r14}
+	bl      DivQ24Async
+	pop     {r14}
+.global DivQ24Result
+DivQ24Result:
+	ldr     r2, =#0x04000280
 wait0:
 	ldrh    r0,[r2]
 	ands    r0, r0, #0x8000
@@ -22,8 +32,8 @@ wait0:
 	orr     r0, r0, r1, lsl #24
 	bx      r14
 
-.global _Z4Sqrt5Fix24IiE
-_Z4Sqrt5Fix24IiE:
+.global _Z12SqrtQ24Async5Fix24IiE
+_Z12SqrtQ24Async5Fix24IiE:
 	push   {r4, r14}
 	ldr     r4,=#0x04000208
 	ldrh    r14,[r4]
@@ -39,6 +49,17 @@ _Z4Sqrt5Fix24IiE:
 	str     r2,[r1, #4]
 	ldrh    r0,[r4]
 	strh    r14,[r4]
+	pop    {r4,r14}
+	bx      r14
+
+.global _Z12HardwareSqrt5Fix24IiE
+_Z12HardwareSqrt5Fix24IiE:
+	push    {r14}
+	bl      _Z12SqrtQ24Async5Fix24IiE
+	pop     {r14}
+.global _Z13SqrtQ24Resultv
+_Z13SqrtQ24Resultv:
+	ldr     r12,=#0x040002B0
 wait2:
 	ldrh    r0,[r12]
 	ands    r0, r0, #0x8000
@@ -47,5 +68,4 @@ wait2:
 	ldr     r0,[r0]
 	add     r0, r0, #1
 	mov     r0, r0, asr #1
-	pop    {r4,r14}
 	bx      r14
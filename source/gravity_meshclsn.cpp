@@ -1,4 +1,7 @@
+#include "gravity_meshclsn.h"
 #include "gravity_actor_extension.h"
+#include "gravity_capsule_clsn.h"
+#include <optional>
 
 extern Actor* behavingActor;
 extern const Actor* spawningActor;
@@ -35,17 +38,97 @@ public:
 
 	void Deactivate() { extension = nullptr; }
 	ActorExtension* GetActorExtension() { return extension; }
+	BgCh* GetBgCh() { return bgch; }
+	Func* GetFunc() { return func; }
 	constexpr bool IsActive() const { return extension; }
 	consteval Transform() = default;
 }
 static constinit transform;
 
+// The queries of the active ClsnBatch that still have to be rotated back
+static struct BatchState
+{
+	struct Query
+	{
+		BgCh* bgch;
+		Transform::Func* func;
+	};
+
+	static constexpr unsigned maxNumQueries = 8;
+
+	const Actor* actor;
+	ActorExtension* extension; // nullptr if the actor is in a trivial field
+	Query queries[maxNumQueries];
+	unsigned numQueries;
+
+	// Returns false if there is no room left, in which case the query has to be restored now
+	bool Defer(BgCh& bgch, Transform::Func& func)
+	{
+		// A query that is detected again is still rotated from the first time
+		for (unsigned i = 0; i < numQueries; ++i)
+			if (queries[i].bgch == &bgch)
+				return true;
+
+		if (numQueries == maxNumQueries)
+			return false;
+
+		queries[numQueries++] = {&bgch, &func};
+
+		return true;
+	}
+}
+batch;
+
+ClsnBatch::ClsnBatch(Actor& actor):
+	owner(!batch.actor)
+{
+	if (!owner) return;
+
+#ifdef GRAVITY_DEBUG_COUNTERS
+	extern unsigned bgChTransformCounter;
+	++bgChTransformCounter;
+#endif
+
+	auto& extension = ActorExtension::Get(actor);
+
+	batch.actor = &actor;
+	batch.extension = extension.IsInTrivialField() ? nullptr : &extension;
+	batch.numQueries = 0;
+}
+
+ClsnBatch::~ClsnBatch()
+{
+	if (!owner) return;
+
+	if (ActorExtension* extension = batch.extension)
+	{
+		const Vector3& actorPos = extension->GetActor().pos;
+		const Matrix3x3& rotation = extension->GetGravityMatrix();
+
+		for (unsigned i = 0; i < batch.numQueries; ++i)
+			batch.queries[i].func(*batch.queries[i].bgch, actorPos, rotation, true);
+	}
+
+	batch.actor = nullptr;
+}
+
 template<class T, std::invocable<T&, const Vector3&, const Matrix3x3&, bool> F>
 static void ApplyBgChTransform(T& bgch, F&&)
 {
 	[](BgCh& bgch, Transform::Func& func) // a lambda to avoid code duplication
 	{
-		if (Actor* actor = bgch.objPtr ?: behavingActor)
+		Actor* actor = bgch.objPtr ?: behavingActor;
+
+		if (actor && actor == batch.actor)
+		{
+			// The actor has already been looked up by the batch
+			if (ActorExtension* extension = batch.extension)
+			{
+				transform.Activate(*extension, bgch, func);
+				transform(extension->savedPos, extension->GetGravityMatrix());
+			}
+		}
+		else if (actor)
 		{
 #ifdef GRAVITY_DEBUG_COUNTERS
 			extern unsigned bgChTransformCounter;
@@ -74,6 +157,12 @@ static void RestoreBgChTransform()
 	
 	auto* extension = transform.GetActorExtension();
 
+	if (batch.actor && extension == batch.extension && batch.Defer(*transform.GetBgCh(), *transform.GetFunc()))
+	{
+		transform.Deactivate();
+		return;
+	}
+
 	transform(extension->GetActor().pos, extension->GetGravityMatrix().Transpose());
 	transform.Deactivate();
 }
@@ -91,11 +180,20 @@ repl_020385a0: @ the beginning of RaycastLine::DetectClsnStageOnly
 constinit const RaycastGround* currRaycastGround = nullptr;
 constinit const GravityField* raycastGroundField = nullptr;
 
+// The substitute ground ray is first cast over the quarter of it closest to the actor,
+// and over the rest only on a miss, so that most triangles are skipped for grounded actors
+static constinit bool raycastGroundFarProbe = false;
+
+static constinit RaycastLine* currLine = nullptr;
+static constinit SphereClsn* currSphere = nullptr;
+
 RaycastLine& BeforeClsn(RaycastLine& line)
 {
+	currLine = &line;
+
 	ApplyBgChTransform(line, [](RaycastLine& line, const Vector3& actorPos, const auto& rotation, bool afterClsn)
 	{
-		line.line.pos0.RotateAround(actorPos, rotation);
+		FusedRotateAround(line.line.pos0, actorPos, rotation);
 
 		if (currRaycastGround && !afterClsn)
 		{
@@ -112,14 +210,18 @@ RaycastLine& BeforeClsn(RaycastLine& line)
 					v *= 1024._f / altitude;
 			}
 
-			line.SetObjAndLine(p0, p0 - v, line.objPtr);
+			if (raycastGroundFarProbe)
+				line.SetObjAndLine(p0 - (v >> 2), p0 - v, line.objPtr);
+			else
+				line.SetObjAndLine(p0, p0 - (v >> 2), line.objPtr);
+
 			line.result = currRaycastGround->result;
 		}
 		else
 		{
-			line.line.pos1.RotateAround(actorPos, rotation);
-			line.average.RotateAround(actorPos, rotation);
-			line.clsnPos.RotateAround(actorPos, rotation);
+			FusedRotateAround(line.line.pos1, actorPos, rotation);
+			FusedRotateAround(line.average, actorPos, rotation);
+			FusedRotateAround(line.clsnPos, actorPos, rotation);
 		}
 	});
 
@@ -134,32 +236,117 @@ repl_02038b7c: @ the beginning of SphereClsn::DetectClsn
 
 SphereClsn& BeforeClsn(SphereClsn& sphere)
 {
+	currSphere = &sphere;
+
 	ApplyBgChTransform(sphere, [](SphereClsn& sphere, const Vector3& actorPos, const auto& rotation, bool afterClsn)
 	{
-		sphere.pos.RotateAround(actorPos, rotation);
+		FusedRotateAround(sphere.pos, actorPos, rotation);
 	});
 
 	return sphere;
 }
 
-asm("nsub_0203881c = _Z9AfterClsnb"); // the end of RayCastLine::DetectClsn
-asm("nsub_02038630 = _Z9AfterClsnb"); // the end of RayCastLine::DetectClsnStageOnly
-asm("nsub_02038e9c = _Z9AfterClsnb"); // the end of SphereClsn::DetectClsn
+asm("nsub_0203881c = _Z13AfterLineClsnb");   // the end of RayCastLine::DetectClsn
+asm("nsub_02038630 = _Z13AfterLineClsnb");   // the end of RayCastLine::DetectClsnStageOnly
+asm("nsub_02038e9c = _Z15AfterSphereClsnb"); // the end of SphereClsn::DetectClsn
 
-bool AfterClsn(bool res)
+void TransformNormal(Vector3& normal)
 {
+	if (auto* extension = transform.GetActorExtension())
+	{
+		FusedMul(normal, extension->GetGravityMatrix().Transpose(), normal);
+		normal.NormalizeTwice();
+	}
+}
+
+// The capsule colliders are tested in world space, before the transform is restored.
+// Their results are written the same way as those of the mesh colliders,
+// with the normals brought into the space of the actor by TransformNormal.
+
+static void SetCapsuleResult(ClsnResult& result, const CapsuleClsn& clsn, const Vector3& normal)
+{
+	result = ClsnResult();
+	result.surfaceInfo.clps = clsn.GetCLPS();
+	result.surfaceInfo.normal = normal;
+}
+
+bool AfterLineClsn(bool res)
+{
+	RaycastLine& line = *currLine;
+	currLine = nullptr;
+
+	Vector3 clsnPos, normal;
+	const Vector3& end = line.hadCollision ? line.clsnPos : line.line.pos1;
+
+	if (const CapsuleClsn* clsn = CapsuleClsn::RaycastAll(clsnPos, normal, line.line.pos0, end))
+	{
+		TransformNormal(normal);
+		SetCapsuleResult(line.result, *clsn, normal);
+
+		line.clsnPos = clsnPos;
+		line.hadCollision = true;
+		res = true;
+	}
+
 	RestoreBgChTransform();
 
 	return res;
 }
 
-void TransformNormal(Vector3& normal)
+bool AfterSphereClsn(bool res)
 {
-	if (auto* extension = transform.GetActorExtension())
+	SphereClsn& sphere = *currSphere;
+	currSphere = nullptr;
+
+	auto* extension = transform.GetActorExtension();
+
+	// The pushback of the meshes is in the space of the actor, like the normals,
+	// so it is rotated into world space to continue from where the meshes left the sphere
+	Vector3 center = sphere.pushback;
+
+	if (extension)
+		FusedMul(center, extension->GetGravityMatrix(), center);
+
+	center += sphere.pos;
+
+	Vector3 pushback, normal;
+
+	if (const CapsuleClsn* clsn = CapsuleClsn::CalculatePushbackAll(pushback, normal, center, sphere.radius))
 	{
-		normal *= extension->GetGravityMatrix().Transpose();
-		normal.NormalizeTwice();
+		if (extension)
+			FusedMul(pushback, extension->GetGravityMatrix().Transpose(), pushback);
+
+		TransformNormal(normal);
+
+		sphere.pushback += pushback;
+		sphere.resultFlags |= SphereClsn::COLLISION_EXISTS;
+
+		// The same slope limit as the floors of the meshes
+		if (normal.y > 0.5_f)
+		{
+			sphere.resultFlags |= SphereClsn::ON_GROUND;
+			sphere.floorNormal = normal;
+			SetCapsuleResult(sphere.floorResult, *clsn, normal);
+		}
+		else if (normal.y >= -0.5_f)
+		{
+			sphere.resultFlags |= SphereClsn::ON_WALL;
+			sphere.wallNormal = normal;
+			SetCapsuleResult(sphere.wallResult, *clsn, normal);
+		}
+		else
+		{
+			sphere.resultFlags |= SphereClsn::ON_CEILING;
+			sphere.ceilingNormal = normal;
+			SetCapsuleResult(sphere.ceilingResult, *clsn, normal);
+		}
+
+		res = true;
 	}
+
+	RestoreBgChTransform();
+
+	return res;
 }
 
 void nsub_01ffd91c(void*, void*, Vector3& normal)
@@ -185,50 +372,205 @@ nsub_02038f48 = _Z15TransformNormalR7Vector3
 
 bool ContinueToDetectClsn(RaycastGround&);
 
+extern unsigned frameCounter;
+
+// In non-trivial fields, ground raycasts are much more expensive than in vanilla,
+// and the same actor often casts the same ray multiple times per frame.
+// The cached results are valid until the end of the frame or until a mesh collider moves.
+class GroundRaycastCache
+{
+public:
+	struct Key
+	{
+		const Actor* actor;
+		const GravityField* field;
+		Vector3 pos;
+		Vector3 pivot;
+		decltype(RaycastGround::flags) flags;
+		uint16_t matrixVersion;
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	struct Result
+	{
+		decltype(RaycastGround::flags) flags;
+		decltype(RaycastGround::result) result;
+		Fix12i clsnPosY;
+		decltype(RaycastGround::hadCollision) hadCollision;
+		bool detected;
+
+		void ApplyTo(RaycastGround& raycastGround) const
+		{
+			raycastGround.flags = flags;
+			raycastGround.result = result;
+			raycastGround.clsnPosY = clsnPosY;
+			raycastGround.hadCollision = hadCollision;
+		}
+	};
+
+private:
+	struct Entry
+	{
+		Key key;
+		Result result;
+	};
+
+	static constexpr unsigned maxNumEntries = 4;
+
+	Entry entries[maxNumEntries];
+	unsigned numEntries;
+	unsigned nextEntryID;
+	unsigned frameID;
+
+public:
+	const Result* Find(const Key& key)
+	{
+		if (frameID != frameCounter)
+		{
+			frameID = frameCounter;
+			Invalidate();
+		}
+
+		for (unsigned i = 0; i < numEntries; ++i)
+			if (entries[i].key == key)
+				return &entries[i].result;
+
+		return nullptr;
+	}
+
+	void Insert(const Key& key, const Result& result)
+	{
+		entries[nextEntryID] = {key, result};
+
+		if (numEntries < maxNumEntries)
+			++numEntries;
+
+		nextEntryID = (nextEntryID + 1) % maxNumEntries;
+	}
+
+	void Invalidate()
+	{
+		numEntries = 0;
+		nextEntryID = 0;
+	}
+}
+static groundRaycastCache;
+
+// The vanilla ground raycast only knows about the meshes, so in trivial fields the capsule
+// colliders are tested along the same vertical ray, down to the mesh hit if there is one
+// and otherwise as far as the substitute ray reaches in non-trivial fields
+static bool DetectTrivialGroundClsn(RaycastGround& raycastGround)
+{
+	bool detected = ContinueToDetectClsn(raycastGround);
+
+	const Vector3& pos0 = raycastGround.pos;
+	Vector3 pos1 = pos0;
+	pos1.y = raycastGround.hadCollision ? raycastGround.clsnPosY : pos0.y - 1024._f;
+
+	Vector3 clsnPos, normal;
+
+	if (const CapsuleClsn* clsn = CapsuleClsn::RaycastAll(clsnPos, normal, pos0, pos1))
+	{
+		SetCapsuleResult(raycastGround.result, *clsn, normal);
+
+		raycastGround.clsnPosY = clsnPos.y;
+		raycastGround.hadCollision = true;
+		detected = true;
+	}
+
+	return detected;
+}
+
 bool nsub_02038f44(RaycastGround& raycastGround)
 {
 	const Vector3& pos0 = raycastGround.pos;
 	const GravityField* field;
 	Actor* actor = raycastGround.objPtr ?: behavingActor;
+	GroundRaycastCache::Key key = {actor, nullptr, pos0, {}, raycastGround.flags, 0};
 
 	if (actor)
 	{
 		const ActorExtension& extension = ActorExtension::Get(*actor);
 
 		if (extension.IsInTrivialField())
-			return ContinueToDetectClsn(raycastGround);
+			return DetectTrivialGroundClsn(raycastGround);
 
 		field = &extension.GetGravityField();
+
+		// The ray is rotated around the saved position of the actor in BeforeClsn
+		key.pivot = extension.savedPos;
+		key.matrixVersion = extension.GetGravityMatrixVersion();
 	}
 	else
 	{
 		field = &GravityField::GetFieldAt(pos0);
 
 		if (field->IsTrivial())
-			return ContinueToDetectClsn(raycastGround);
+			return DetectTrivialGroundClsn(raycastGround);
+	}
+
+	key.field = field;
+
+	if (const auto* cached = groundRaycastCache.Find(key))
+	{
+		cached->ApplyTo(raycastGround);
+
+		return cached->detected;
 	}
 
 	currRaycastGround = &raycastGround;
 	raycastGroundField = field;
 
 	RaycastLine line;
-	line.line.pos0 = pos0;
-	line.objPtr = actor;
-	line.flags = raycastGround.flags;
 
-	const bool detected = line.DetectClsn();
+	// Both probes only use distances along the line, which the rotation back doesn't change
+	std::optional<ClsnBatch> clsnBatch;
+
+	if (actor)
+		clsnBatch.emplace(*actor);
+
+	const auto detectProbe = [&](bool farProbe)
+	{
+		raycastGroundFarProbe = farProbe;
+
+		line.line.pos0 = pos0;
+		line.objPtr = actor;
+		line.flags = raycastGround.flags;
+
+		return line.DetectClsn();
+	};
+
+	bool detected = detectProbe(false);
+	Fix12i nearProbeLength = 0_f;
+
+	if (!detected)
+	{
+		nearProbeLength = line.line.pos0.Dist(line.line.pos1);
+		detected = detectProbe(true);
+	}
+
 	currRaycastGround = nullptr;
 	raycastGroundField = nullptr;
+	raycastGroundFarProbe = false;
 
 	raycastGround.flags = line.flags;
 	raycastGround.result = line.result;
-	raycastGround.clsnPosY = pos0.y - line.line.pos0.Dist(line.clsnPos);
+	raycastGround.clsnPosY = pos0.y - nearProbeLength - line.line.pos0.Dist(line.clsnPos);
 	raycastGround.hadCollision = line.hadCollision;
 
+	groundRaycastCache.Insert(key, {
+		raycastGround.flags,
+		raycastGround.result,
+		raycastGround.clsnPosY,
+		raycastGround.hadCollision,
+		detected
+	});
+
 	return detected;
 }
 
-static const Matrix4x3& TransformMMC(MovingMeshCollider& meshClsn, const Matrix4x3& transform, Matrix4x3& res)
+static const Actor* GetMMCActor(const MovingMeshCollider& meshClsn)
 {
 	const Actor* actor = meshClsn.actor;
 
@@ -240,22 +582,71 @@ static const Matrix4x3& TransformMMC(MovingMeshCollider& meshClsn, const Matrix4
 			actor = behavingActor;
 	}
 
-	if (actor)
-	{
-		const auto& extension = ActorExtension::Get(*actor);
+	return actor;
+}
 
-		if (!extension.IsInTrivialField())
-		{
-			res.Linear() = extension.GetGravityMatrix()(transform.Linear());
-			res.c3 = transform.c3;
+static const Matrix4x3& TransformMMC(const ActorExtension* extension, const Matrix4x3& transform, Matrix4x3& res)
+{
+	if (extension && !extension->IsInTrivialField())
+	{
+		FusedMul(res.Linear(), extension->GetGravityMatrix(), transform.Linear());
+		res.c3 = transform.c3;
 
-			return res;
-		}
+		return res;
 	}
 
 	return transform;
 }
 
+// Stationary platforms are transformed every frame with the same matrix,
+// so the last transforms of the most recently transformed colliders are cached.
+class MMCTransformCache
+{
+public:
+	struct Entry
+	{
+		const MovingMeshCollider* meshClsn;
+		const Actor* actor;
+		Matrix4x3 transform;
+		Matrix4x3 res;
+		uint16_t matrixVersion;
+		short angleY;
+		bool repeated; // whether the collider has been transformed the same way twice in a row
+	};
+
+private:
+	static constexpr unsigned maxNumEntries = 16;
+
+	Entry entries[maxNumEntries];
+	unsigned nextEntryID;
+
+public:
+	Entry* Find(const MovingMeshCollider& meshClsn)
+	{
+		for (Entry& entry : entries)
+			if (entry.meshClsn == &meshClsn)
+				return &entry;
+
+		return nullptr;
+	}
+
+	Entry& Insert(const MovingMeshCollider& meshClsn)
+	{
+		Entry& entry = entries[nextEntryID];
+		nextEntryID = (nextEntryID + 1) % maxNumEntries;
+		entry.meshClsn = &meshClsn;
+
+		return entry;
+	}
+
+	void Remove(const MovingMeshCollider& meshClsn)
+	{
+		if (Entry* entry = Find(meshClsn))
+			entry->meshClsn = nullptr;
+	}
+}
+static mmcTransformCache;
+
 asm(R"(
 _Z19ContinueToTransformR18MovingMeshColliderRK9Matrix4x3s:
 	push  {r4-r11, r14}
@@ -280,16 +671,50 @@ void nsub_0203a1e0 (
 	short angleY, CLPS_Block& clps
 )
 {
+	groundRaycastCache.Invalidate();
+	mmcTransformCache.Remove(meshClsn);
+
+	const Actor* actor = GetMMCActor(meshClsn);
+	const ActorExtension* extension = actor ? &ActorExtension::Get(*actor) : nullptr;
+
 	Matrix4x3 res;
-	const Matrix4x3& newTransform = TransformMMC(meshClsn, transform, res);
+	const Matrix4x3& newTransform = TransformMMC(extension, transform, res);
 	ContinueToSetFile(meshClsn, clsnFile, newTransform, scale, angleY, clps);
 }
 
 void nsub_02039f20(MovingMeshCollider& meshClsn, const Matrix4x3& transform, short angleY)
 {
-	Matrix4x3 res;
-	const Matrix4x3& newTransform = TransformMMC(meshClsn, transform, res);
-	ContinueToTransform(meshClsn, newTransform, angleY);
+	const Actor* actor = GetMMCActor(meshClsn);
+	const ActorExtension* extension = actor ? &ActorExtension::Get(*actor) : nullptr;
+	const uint16_t matrixVersion = extension ? extension->GetGravityMatrixVersion() : 0;
+
+	auto* entry = mmcTransformCache.Find(meshClsn);
+
+	if (entry && entry->actor == actor && entry->matrixVersion == matrixVersion &&
+		entry->angleY == angleY && entry->transform == transform)
+	{
+		// Once the collider has been transformed the same way twice in a row,
+		// both its previous and current transforms are the same as the new one,
+		// so transforming it again wouldn't change anything.
+		if (entry->repeated) return;
+
+		entry->repeated = true;
+	}
+	else
+	{
+		if (!entry)
+			entry = &mmcTransformCache.Insert(meshClsn);
+
+		entry->actor = actor;
+		entry->transform = transform;
+		entry->res = TransformMMC(extension, transform, entry->res);
+		entry->matrixVersion = matrixVersion;
+		entry->angleY = angleY;
+		entry->repeated = false;
+	}
+
+	groundRaycastCache.Invalidate();
+	ContinueToTransform(meshClsn, entry->res, angleY);
 }
 
 auto repl_020383a4() // before calling the function that calls beforeClsnCallback
@@ -341,7 +766,7 @@ const WithMeshClsn& BeforeWMCUpdate(const WithMeshClsn& wmClsn)
 	savedPrevPos = actor.prevPos;
 
 	if (!trivial)
-		actor.prevPos.RotateAround(actor.pos, extension.GetGravityMatrix().Transpose());
+		FusedRotateAround(actor.prevPos, actor.pos, extension.GetGravityMatrix().Transpose());
 
 	return wmClsn;
 }
@@ -7,6 +7,11 @@ int repl_0202cae0() // Clean up resources before changing levels
 	GravityField::Cleanup();
 	CamCtrl::Cleanup();
 
+	extern void ClearShadowUpVectorCache();
+	extern void ClearParticleBasisCache();
+	ClearShadowUpVectorCache();
+	ClearParticleBasisCache();
+
 	return 0x91c; // the hook replaces ldr r0,=0x91c
 }
 
@@ -53,12 +58,7 @@ void AdjustInputAngle(Player& player)
 	}
 
 	Vector3 forward;
-	SphericalForwardField (
-		forward,
-		static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c0),
-		static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c2),
-		Vector3_Q24::Raw(extension.GetUpVectorQ12() << 12).Normalized()
-	);
+	viewContext.CalculateForwardField(forward, Vector3_Q24::Raw(extension.GetUpVectorQ12() << 12).Normalized());
 
 	forward >>= 12;
 
@@ -162,8 +162,8 @@ extern "C" void TransformCarryMatrix(Player& player)
 	const Matrix3x3& g1 = playerExtension.GetGravityMatrix();
 	const Vector3 pivot = holdingExtension.GetRealValue<&Actor::pos>() >> 3;
 
-	MATRIX_SCRATCH_PAPER.Linear() = g1.Transpose()(g0(MATRIX_SCRATCH_PAPER.Linear()));
-	MATRIX_SCRATCH_PAPER.c3.RotateAround(pivot, g0);
+	MatrixChain(g1.Transpose(), g0).Apply(MATRIX_SCRATCH_PAPER.Linear(), MATRIX_SCRATCH_PAPER.Linear());
+	FusedRotateAround(MATRIX_SCRATCH_PAPER.c3, pivot, g0);
 }
 
 asm(R"(
@@ -1,4 +1,5 @@
 #include "gravity_actor_extension.h"
+#include "gravity_cam_ctrl.h"
 
 const ActorBase* renderingActorBase = nullptr;
 
@@ -28,11 +29,53 @@ nsub_020443c8:
 
 static void TransformModelMatrix(Matrix4x3& modelMatrix, const Matrix3x3& gravityMatrix, const Vector3& pos)
 {
-	modelMatrix.Linear() = gravityMatrix(modelMatrix.Linear());
+	FusedMul(modelMatrix.Linear(), gravityMatrix, modelMatrix.Linear());
 
-	modelMatrix.c3.RotateAround(pos >> 3, gravityMatrix);
+	FusedRotateAround(modelMatrix.c3, pos >> 3, gravityMatrix);
 }
 
+extern unsigned frameCounter;
+
+// Actors with several models render them one after another with the same gravity transform in view
+// space, VIEW_MATRIX_ASR_3 * G * INV_VIEW_MATRIX_ASR_3, so it's composed once and reused until the
+// view matrices change (once per frame), the actor moves or its gravity matrix changes.
+class ViewGravityMatrixCache
+{
+	const Actor* actor = nullptr;
+	Vector3 pos;
+	unsigned frameID;
+	uint16_t matrixVersion;
+	Matrix4x3 matrix;
+
+public:
+	const Matrix4x3& Get(const Actor& actor, const ActorExtension& extension)
+	{
+		if (this->actor == &actor && frameID == frameCounter &&
+			matrixVersion == extension.GetGravityMatrixVersion() && pos == actor.pos)
+		{
+			return matrix;
+		}
+
+		this->actor = &actor;
+		pos = actor.pos;
+		frameID = frameCounter;
+		matrixVersion = extension.GetGravityMatrixVersion();
+
+		const Matrix3x3& gravityMatrix = extension.GetGravityMatrix();
+
+		MatrixChain(VIEW_MATRIX_ASR_3.Linear(), gravityMatrix).Apply(matrix.Linear(), INV_VIEW_MATRIX_ASR_3.Linear());
+
+		matrix.c3 = INV_VIEW_MATRIX_ASR_3.c3;
+		FusedRotateAround(matrix.c3, pos >> 3, gravityMatrix);
+		FusedMul(matrix.c3, VIEW_MATRIX_ASR_3.Linear(), matrix.c3);
+		matrix.c3 += VIEW_MATRIX_ASR_3.c3;
+
+		return matrix;
+	}
+};
+
+static ViewGravityMatrixCache viewGravityMatrixCache;
+
 extern "C" const Matrix4x3* TransformRenderingModel(const Matrix4x3* matrixIn)
 {
 	if (renderingActorBase == nullptr)
@@ -48,15 +91,14 @@ extern "C" const Matrix4x3* TransformRenderingModel(const Matrix4x3* matrixIn)
 	if (extension.IsInTrivialField())
 		return matrixIn;
 
+	const Matrix4x3& viewGravityMatrix = viewGravityMatrixCache.Get(*renderingActor, extension);
+
 	if (matrixIn == nullptr)
-		matrixIn = &Matrix4x3::IDENTITY;
+		return &viewGravityMatrix;
 
 	static constinit Matrix4x3 matrixOut;
-	matrixOut = INV_VIEW_MATRIX_ASR_3(*matrixIn);
-
-	TransformModelMatrix(matrixOut, extension.GetGravityMatrix(), renderingActor->pos);
+	matrixOut = viewGravityMatrix(*matrixIn);
 
-	matrixOut = VIEW_MATRIX_ASR_3(matrixOut);
 	return &matrixOut;
 }
 
@@ -81,6 +123,54 @@ repl_02015d88: @ in ShadowModel::RenderAll
 	b      TransformRenderingShadow
 )");
 
+// Shadows without an actor belong to objects like coins that don't move, and the
+// fields don't change during a level, so their up vectors are remembered by position
+// instead of searching the field list for each of them on every frame
+class ShadowUpVectorCache
+{
+	struct Entry
+	{
+		Vector3 pos;
+		Vector3 upVector; // zero if the entry is empty
+	};
+
+	static constexpr unsigned numEntriesLog2 = 5;
+
+	Entry entries[1 << numEntriesLog2];
+
+	static unsigned Hash(const Vector3& pos)
+	{
+		return (pos.x.val ^ pos.y.val * 3 ^ pos.z.val * 5) * 0x9e3779b1u >> (32 - numEntriesLog2);
+	}
+
+public:
+	const Vector3& Get(const Vector3& pos)
+	{
+		Entry& entry = entries[Hash(pos)];
+
+		if (entry.pos != pos || entry.upVector == Vector3{})
+		{
+			entry.pos = pos;
+			entry.upVector = GravityField::GetFieldAt(pos).GetUpVectorQ12(pos);
+		}
+
+		return entry.upVector;
+	}
+
+	void Clear()
+	{
+		for (Entry& entry : entries)
+			entry.upVector = {};
+	}
+};
+
+static ShadowUpVectorCache shadowUpVectorCache;
+
+void ClearShadowUpVectorCache()
+{
+	shadowUpVectorCache.Clear();
+}
+
 extern "C" void TransformRenderingShadow(const Matrix4x3& viewMatrix, Matrix4x3& shadowMatrix, const Actor* actor)
 {
 	if (actor)
@@ -99,7 +189,7 @@ extern "C" void TransformRenderingShadow(const Matrix4x3& viewMatrix, Matrix4x3&
 		const Vector3 pos = shadowMatrix.c3 << 3;
 
 		// normally the y-coordinate of the translation of the shadow is increased by 2 fxu
-		shadowMatrix.c3 += GravityField::GetFieldAt(pos).GetUpVectorQ12(pos) << 1;
+		shadowMatrix.c3 += shadowUpVectorCache.Get(pos) << 1;
 	}
 
 	shadowMatrix = viewMatrix(shadowMatrix);
@@ -114,9 +204,5 @@ repl_0202b94c:
 
 extern "C" void RenderSkyBox(Model& skybox)
 {
-	Matrix4x3 matrix;
-	matrix.Linear() = VIEW_MATRIX_ASR_3.Linear();
-	matrix.c3 = {};
-
-	skybox.data.Render(&matrix, nullptr);
+	skybox.data.Render(&viewContext.skyBoxMatrix, nullptr);
 }
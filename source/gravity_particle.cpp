@@ -1,4 +1,5 @@
 #include "gravity_actor_extension.h"
+#include "gravity_cam_ctrl.h"
 
 using namespace Particle;
 
@@ -7,17 +8,12 @@ extern Actor* behavingActor;
 
 static void CalculateFieldMatrix(Matrix3x3& res, Vector3_Q24 upAxis)
 {
-	SphericalMatrixField (
-		res,
-		static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c0),
-		static_cast<Vector3_Q24>(INV_VIEW_MATRIX_ASR_3.c2),
-		upAxis
-	);
+	SphericalMatrixField(res, viewContext.camXAxis, viewContext.camZAxis, upAxis);
 }
 
 static void RotateAroundActor(Vector3& posAsr3, const Actor& actor, const ActorExtension& extension)
 {
-	posAsr3.RotateAround(actor.pos >> 3, extension.GetGravityMatrix());
+	FusedRotateAround(posAsr3, actor.pos >> 3, extension.GetGravityMatrix());
 }
 
 asm(R"(
@@ -32,18 +28,101 @@ nsub_02049f34:
 	b      0x02049f38
 )");
 
+// Most particle systems don't move, so the field basis of each system is kept until it moves
+// or the camera turns far enough to change the result of SphericalForwardField noticeably
+class ParticleBasisCache
+{
+	struct Entry
+	{
+		const System* system = nullptr;
+		Vector3 posAsr3;
+		Vector3_Q24 camXAxis;
+		Vector3_Q24 camZAxis;
+		Vector3_Q24 upVector;
+		Matrix3x3 basis;
+		bool trivial;
+	};
+
+	static constexpr unsigned numEntriesLog2 = 4;
+	static constexpr int maxCamAxisDiff = 16 << 12; // in raw Q24 units, about 0.2 degrees
+
+	Entry entries[1 << numEntriesLog2];
+
+	static unsigned Hash(const System& system)
+	{
+		return reinterpret_cast<uintptr_t>(&system) * 0x9e3779b1u >> (32 - numEntriesLog2);
+	}
+
+	static int Diff(const Vector3_Q24& v0, const Vector3_Q24& v1)
+	{
+		return std::abs((v0.data.x - v1.data.x).val) + std::abs((v0.data.y - v1.data.y).val) + std::abs((v0.data.z - v1.data.z).val);
+	}
+
+public:
+	// Returns nullptr if the system is in a trivial field
+	const Matrix3x3* Get(const System& system)
+	{
+		Entry& entry = entries[Hash(system)];
+		const Vector3_Q24& camXAxis = viewContext.camXAxis;
+		const Vector3_Q24& camZAxis = viewContext.camZAxis;
+
+		if (entry.system == &system && entry.posAsr3 == system.posAsr3)
+		{
+			if (entry.trivial)
+				return nullptr;
+
+			if (Diff(entry.camXAxis, camXAxis) + Diff(entry.camZAxis, camZAxis) <= maxCamAxisDiff)
+				return &entry.basis;
+		}
+		else
+		{
+			entry.system = &system;
+			entry.posAsr3 = system.posAsr3;
+
+			const Vector3 pos = system.posAsr3 << 3;
+			const GravityField& field = GravityField::GetFieldAt(pos);
+
+			entry.trivial = field.IsTrivial();
+
+			if (entry.trivial)
+				return nullptr;
+
+			entry.upVector = field.GetUpVectorQ24(pos);
+		}
+
+		entry.camXAxis = camXAxis;
+		entry.camZAxis = camZAxis;
+
+		CalculateFieldMatrix(entry.basis, entry.upVector);
+
+		return &entry.basis;
+	}
+
+	void Clear()
+	{
+		for (Entry& entry : entries)
+			entry.system = nullptr;
+	}
+};
+
+static ParticleBasisCache particleBasisCache;
+
+void ClearParticleBasisCache()
+{
+	particleBasisCache.Clear();
+}
+
 extern "C" void SetParticleViewMatrix(const System& system)
 {
-	const Vector3 pos = system.posAsr3 << 3;
-	const GravityField& field = GravityField::GetFieldAt(pos);
+	const Matrix3x3* basis = particleBasisCache.Get(system);
 
-	if (field.IsTrivial())
+	if (!basis)
 	{
 		particleViewMatrix = VIEW_MATRIX_ASR_3;
 		return;
 	}
 
-	CalculateFieldMatrix(particleViewMatrix.Linear(), field.GetUpVectorQ24(pos));
+	particleViewMatrix.Linear() = *basis;
 
 	particleViewMatrix.c3 = system.posAsr3 - particleViewMatrix.Linear()(system.posAsr3);
 	particleViewMatrix = VIEW_MATRIX_ASR_3(particleViewMatrix);
@@ -84,6 +163,84 @@ nsub_02022dd8:
 	b      0x02022ddc
 )");
 
+// Streams the positions through the affine transform m. The matrix is loaded once, and each
+// coordinate is accumulated in 64 bits (smull/smlal) with the translation and rounded once.
+static void TransformPositions(const List& particleList, const Matrix4x3& m)
+{
+	const int m00 = m.c0.x.val, m01 = m.c1.x.val, m02 = m.c2.x.val;
+	const int m10 = m.c0.y.val, m11 = m.c1.y.val, m12 = m.c2.y.val;
+	const int m20 = m.c0.z.val, m21 = m.c1.z.val, m22 = m.c2.z.val;
+
+	const int64_t tx = (int64_t(m.c3.x.val) << 12) + 0x800;
+	const int64_t ty = (int64_t(m.c3.y.val) << 12) + 0x800;
+	const int64_t tz = (int64_t(m.c3.z.val) << 12) + 0x800;
+
+	for (auto& particle : particleList)
+	{
+		Vector3& p = particle.posAsr3;
+
+		const int64_t x = p.x.val;
+		const int64_t y = p.y.val;
+		const int64_t z = p.z.val;
+
+		p.x.val = (m00 * x + m01 * y + m02 * z + tx) >> 12;
+		p.y.val = (m10 * x + m11 * y + m12 * z + ty) >> 12;
+		p.z.val = (m20 * x + m21 * y + m22 * z + tz) >> 12;
+	}
+}
+
+// The acceleration of the particles toward the field, in fxu per frame squared divided by 8
+static constexpr Fix12i particleGravityAsr3 = 0.0625_f;
+
+// In fields with particle gravity, each particle's velocity is turned by the rotation of the up vector
+// along the particle's path, so particles curve around the field the way actors do instead of flying
+// off in straight lines, and each particle is pulled down along the up vector at its own position.
+// The up vector near the system is extrapolated from its value and derivative at the system's
+// position, so the field is only evaluated once per system instead of once per particle.
+// The particles and their velocities are in the frame of the system's basis (see SetParticleViewMatrix),
+// so the extrapolation is done in that frame too, where the up vector at the system is the y axis.
+static void BendParticleVelocities(const List& particleList, const GravityField& field, const Vector3& centerAsr3, const Matrix3x3& basis)
+{
+	const Vector3 center = centerAsr3 << 3;
+	constexpr Vector3_Q24 up0 = {0._f24, 1._f24, 0._f24};
+
+	// The derivatives along the axes of the basis are the columns of the world Jacobian times the basis,
+	// so rotating them back with the transposed basis gives the Jacobian in the frame of the particles.
+	Matrix3x3 jacobian; // in Q24 per fxu
+	field.CalculateUpVectorDerivativeQ24(jacobian.c0, center, basis.c0);
+	field.CalculateUpVectorDerivativeQ24(jacobian.c1, center, basis.c1);
+	field.CalculateUpVectorDerivativeQ24(jacobian.c2, center, basis.c2);
+	FusedMul(jacobian, basis.Transpose(), jacobian);
+
+	for (auto& particle : particleList)
+	{
+		Vector3& vel = particle.speedAsr3;
+
+		// The up vector at the particle and its change over the next frame, both in Q24.
+		// The extrapolated up vector grows longer with the distance from the system,
+		// so it is normalized while the change is calculated.
+		Vector3 up, upChange, scaled;
+		FusedMul(up, jacobian, particle.posAsr3 - centerAsr3);
+		up = (up << 3) + up0.data;
+		Vector3_Q24::NormalizeAsync(scaled, up);
+
+		FusedMul(upChange, jacobian, vel);
+		upChange <<= 3;
+		Vector3_Q24::NormalizeResult(up, scaled);
+
+		// Both dot products have the raw units of vel, since up and upChange are in Q24
+		const Fix24i upSpeed = Vector3_Q24::CalculateDot(vel, up);
+		const Fix24i upChangeSpeed = Vector3_Q24::CalculateDot(vel, upChange);
+		const Fix24i downAccel = {upChangeSpeed.val + particleGravityAsr3.val, as_raw};
+
+		Vector3 delta;
+		Vector3_Q24::Multiply(delta, upChange, upSpeed);
+		vel += delta;
+		Vector3_Q24::Multiply(delta, up, downAccel);
+		vel -= delta;
+	}
+}
+
 extern "C" System& TransformParticles(System& system, Vector3& newPosAsr3)
 {
 	const GravityField* field;
@@ -103,8 +260,24 @@ extern "C" System& TransformParticles(System& system, Vector3& newPosAsr3)
 		if (field->IsTrivial()) return system;
 	}
 
-	Matrix4x3 transform0, transform1;
+	const bool bend = field->HasParticleGravity() && !field->IsHomogeneous();
+
+	// Both bases would be built from the same up vector, so the transform would be the identity
+	if (!bend && newPosAsr3 == system.posAsr3)
+		return system;
+
+	// The basis of the frame the particles are currently in
+	Matrix4x3 transform0;
 	CalculateFieldMatrix(transform0.Linear(), field->GetUpVectorQ24(system.posAsr3 << 3));
+
+	// The particles haven't been moved to the new position of the system yet
+	if (bend)
+		BendParticleVelocities(system.particleList, *field, system.posAsr3, transform0.Linear());
+
+	if (newPosAsr3 == system.posAsr3)
+		return system;
+
+	Matrix4x3 transform1;
 	CalculateFieldMatrix(transform1.Linear(), field->GetUpVectorQ24(newPosAsr3 << 3));
 
 	transform0.c3 = system.posAsr3 - newPosAsr3 - transform0.Linear()(system.posAsr3);
@@ -112,8 +285,7 @@ extern "C" System& TransformParticles(System& system, Vector3& newPosAsr3)
 	transform1.c3 = newPosAsr3;
 	transform1 = transform1(transform0);
 
-	for (auto& particle : system.particleList)
-		particle.posAsr3 *= transform1;
+	TransformPositions(system.particleList, transform1);
 
 	return system;
 }
@@ -55,7 +55,7 @@ PlanetCam::PlanetCam(
 	else
 	{
 		camAltitude = field.GetAltitudeAndUpVectorQ24(yAxis, camPos);
-		xAxis = yAxis.Cross(Vector3_Q24{INV_VIEW_MATRIX_ASR_3.c1}).Normalized();
+		xAxis = yAxis.Cross(viewContext.camYAxis).Normalized();
 	}
 
 	Vector3_Q24 playerUp;
@@ -67,7 +67,7 @@ PlanetCam::PlanetCam(
 	if (yAxis.Dot(playerUp) < 0_f24)
 	{
 		yAxis = playerUp;
-		xAxis = yAxis.Cross(Vector3_Q24{INV_VIEW_MATRIX_ASR_3.c1}).Normalized();
+		xAxis = yAxis.Cross(viewContext.camYAxis).Normalized();
 		camPos = player.pos + (camAltitude - targetAltitude) * yAxis.ToQ12();
 	}
 }
@@ -429,7 +429,7 @@ bool PlanetCam::CalculateTransform(Matrix4x3& res, Camera& cam, Player& player)
 	UpdateCamPos(player.pos, playerUp, altitude + cam.unk134);
 
 	const Vector3 targetOffset = playerUp * (targetAltitude + GetSetting<TARGET_VERT_OFFSET>() + cam.unk134 - playerAltitude);
-	const Vector3_Q24 dir = Vector3_Q24::Raw(camPos - player.pos - targetOffset).NormalizedTwice();
+	const Vector3_Q24 dir = Vector3_Q24::Raw(camPos - player.pos - targetOffset).Normalized();
 
 	CalculateRotation(res.Linear(), dir);
 	res.c3 = camPos;